@@ -0,0 +1,393 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ANALYZER_CPP
+#define ANALYZER_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Chip8.h"
+#include "Opcodes.h"
+
+struct BasicBlock
+{
+    uint16_t start{};
+    // One past the last byte of the last instruction
+    uint16_t end{};
+    std::vector<uint16_t> successors;
+    // Subroutine called by the last instruction, if any
+    uint16_t call{};
+    // Ends in Bnnn, the real successors are not known statically
+    bool computedJump{};
+    bool returns{};
+};
+
+struct Function
+{
+    uint16_t entry{};
+    std::vector<uint16_t> blocks;
+    std::vector<uint16_t> callees;
+};
+
+struct AddressRange
+{
+    uint16_t start{};
+    uint16_t end{};
+};
+
+/**
+ * Result of statically walking a ROM.
+ * Addresses are machine addresses, the ROM starts at START_ADDRESS.
+ */
+struct RomAnalysis
+{
+    std::vector<BasicBlock> blocks;
+    std::vector<Function> functions;
+    std::vector<AddressRange> data;
+    std::vector<uint16_t> computedJumps;
+    // Instructions that write at an I known to point into code
+    std::vector<uint16_t> selfModifying;
+    // Bytes those instructions write, code that may not stay as the ROM has it
+    std::vector<AddressRange> codeWrites;
+    // Reachable opcodes the core does not implement
+    std::vector<uint16_t> invalid;
+    // Per ROM byte: CODE_START for the first byte of an instruction, CODE_BODY for the rest
+    std::vector<uint8_t> codeMap;
+
+    static constexpr uint8_t CODE_START = 1;
+    static constexpr uint8_t CODE_BODY = 2;
+
+    [[nodiscard]] bool IsCode(uint16_t address) const
+    {
+        return address >= START_ADDRESS && address - START_ADDRESS < codeMap.size() && codeMap[address - START_ADDRESS];
+    }
+
+    [[nodiscard]] BasicBlock const* FindBlock(uint16_t address) const
+    {
+        const auto found = std::upper_bound(blocks.begin(), blocks.end(), address,
+            [](uint16_t value, BasicBlock const& block) { return value < block.start; });
+
+        if (found == blocks.begin() || address >= (found - 1)->end)
+        {
+            return nullptr;
+        }
+
+        return &*(found - 1);
+    }
+};
+
+/**
+ * Recursive descent over a ROM from START_ADDRESS, following 1nnn/2nnn and skip targets.
+ * Everything is flat arrays indexed by ROM offset, so a whole corpus takes milliseconds.
+ */
+class Analyzer
+{
+    uint8_t const* rom;
+    size_t size;
+
+    [[nodiscard]] bool InRom(unsigned int address) const
+    {
+        return address >= START_ADDRESS && address - START_ADDRESS < size;
+    }
+
+    [[nodiscard]] uint8_t Byte(unsigned int address) const
+    {
+        return InRom(address) ? rom[address - START_ADDRESS] : 0;
+    }
+
+    [[nodiscard]] uint16_t Opcode(unsigned int address) const
+    {
+        return static_cast<uint16_t>((Byte(address) << 8u) | Byte(address + 1));
+    }
+
+    /**
+     * Address after the instruction at `address`.
+     */
+    [[nodiscard]] unsigned int Next(unsigned int address) const
+    {
+        return address + OpLength(DecodeOp(Opcode(address)));
+    }
+
+    Analyzer(uint8_t const* rom, size_t size) : rom(rom), size(std::min<size_t>(size, MAX_ROM_SIZE)) {}
+
+    RomAnalysis Run() const
+    {
+        RomAnalysis result;
+        result.codeMap.assign(size, 0);
+
+        std::vector<uint8_t> leader(size, 0);
+        std::vector<uint8_t> functionEntry(size, 0);
+        std::vector<uint16_t> work;
+
+        auto addTarget = [&](unsigned int target)
+        {
+            if (InRom(target))
+            {
+                leader[target - START_ADDRESS] = 1;
+                work.push_back(static_cast<uint16_t>(target));
+            }
+        };
+
+        addTarget(START_ADDRESS);
+        if (InRom(START_ADDRESS))
+        {
+            functionEntry[0] = 1;
+        }
+
+        // Discover every reachable instruction
+        while (!work.empty())
+        {
+            unsigned int address = work.back();
+            work.pop_back();
+
+            while (InRom(address) && !(result.codeMap[address - START_ADDRESS] & RomAnalysis::CODE_START))
+            {
+                const uint16_t opcode = Opcode(address);
+                const Op op = DecodeOp(opcode);
+                const uint8_t flow = OpFlags(op);
+                const unsigned int length = OpLength(op);
+
+                result.codeMap[address - START_ADDRESS] = RomAnalysis::CODE_START;
+                for (unsigned int i = 1; i < length && InRom(address + i); ++i)
+                {
+                    result.codeMap[address + i - START_ADDRESS] |= RomAnalysis::CODE_BODY;
+                }
+
+                const unsigned int next = address + length;
+
+                if (flow & OP_FLOW_JUMP)
+                {
+                    addTarget(opcode & 0x0FFFu);
+                    break;
+                }
+                if (flow & OP_FLOW_CALL)
+                {
+                    addTarget(opcode & 0x0FFFu);
+                    if (InRom(opcode & 0x0FFFu))
+                    {
+                        functionEntry[(opcode & 0x0FFFu) - START_ADDRESS] = 1;
+                    }
+                    addTarget(next);
+                    break;
+                }
+                if (flow & OP_FLOW_SKIP)
+                {
+                    addTarget(next);
+                    addTarget(Next(next));
+                    break;
+                }
+                if (flow & (OP_FLOW_RETURN | OP_FLOW_STOP | OP_FLOW_COMPUTED))
+                {
+                    if (op == Op::OP_Bnnn)
+                    {
+                        result.computedJumps.push_back(static_cast<uint16_t>(address));
+                    }
+                    if (op == Op::OP_NULL)
+                    {
+                        result.invalid.push_back(static_cast<uint16_t>(address));
+                    }
+                    break;
+                }
+
+                address = next;
+            }
+        }
+
+        // Cut the instructions into basic blocks
+        std::vector<int> blockAt(size, -1);
+        std::vector<uint8_t> inBlock(size, 0);
+
+        for (unsigned int offset = 0; offset < size; ++offset)
+        {
+            if (!(result.codeMap[offset] & RomAnalysis::CODE_START) || inBlock[offset])
+            {
+                continue;
+            }
+
+            BasicBlock block;
+            block.start = static_cast<uint16_t>(START_ADDRESS + offset);
+            unsigned int address = block.start;
+
+            while (true)
+            {
+                inBlock[address - START_ADDRESS] = 1;
+
+                const uint16_t opcode = Opcode(address);
+                const Op op = DecodeOp(opcode);
+                const uint8_t flow = OpFlags(op);
+                const unsigned int next = address + OpLength(op);
+
+                if (flow & OP_FLOW_JUMP)
+                {
+                    block.successors.push_back(opcode & 0x0FFFu);
+                }
+                else if (flow & OP_FLOW_CALL)
+                {
+                    block.call = opcode & 0x0FFFu;
+                    block.successors.push_back(static_cast<uint16_t>(next));
+                }
+                else if (flow & OP_FLOW_SKIP)
+                {
+                    block.successors.push_back(static_cast<uint16_t>(next));
+                    block.successors.push_back(static_cast<uint16_t>(Next(next)));
+                }
+                else if (flow & OP_FLOW_RETURN)
+                {
+                    block.returns = true;
+                }
+                else if (flow & OP_FLOW_COMPUTED)
+                {
+                    block.computedJump = true;
+                }
+                else if (!(flow & OP_FLOW_STOP))
+                {
+                    // Plain instruction, the block goes on unless something else starts here
+                    if (InRom(next) && (result.codeMap[next - START_ADDRESS] & RomAnalysis::CODE_START)
+                        && !leader[next - START_ADDRESS])
+                    {
+                        address = next;
+                        continue;
+                    }
+
+                    block.successors.push_back(static_cast<uint16_t>(next));
+                }
+
+                block.end = static_cast<uint16_t>(std::min<unsigned int>(next, START_ADDRESS + size));
+                break;
+            }
+
+            blockAt[offset] = static_cast<int>(result.blocks.size());
+            result.blocks.push_back(std::move(block));
+        }
+
+        FindSelfModifyingWrites(result);
+
+        // Functions are everything reachable from an entry without following calls
+        std::vector<int> seen(result.blocks.size(), -1);
+
+        for (unsigned int offset = 0; offset < size; ++offset)
+        {
+            if (!functionEntry[offset] || blockAt[offset] < 0)
+            {
+                continue;
+            }
+
+            Function function;
+            function.entry = static_cast<uint16_t>(START_ADDRESS + offset);
+            const int id = static_cast<int>(result.functions.size());
+
+            std::vector<int> stack{blockAt[offset]};
+            while (!stack.empty())
+            {
+                const int current = stack.back();
+                stack.pop_back();
+
+                if (seen[current] == id)
+                {
+                    continue;
+                }
+                seen[current] = id;
+
+                BasicBlock const& block = result.blocks[current];
+                function.blocks.push_back(block.start);
+
+                if (block.call && std::find(function.callees.begin(), function.callees.end(), block.call) == function.callees.end())
+                {
+                    function.callees.push_back(block.call);
+                }
+
+                for (const uint16_t successor : block.successors)
+                {
+                    if (InRom(successor) && blockAt[successor - START_ADDRESS] >= 0)
+                    {
+                        stack.push_back(blockAt[successor - START_ADDRESS]);
+                    }
+                }
+            }
+
+            std::sort(function.blocks.begin(), function.blocks.end());
+            result.functions.push_back(std::move(function));
+        }
+
+        // Whatever is not code is data
+        for (unsigned int offset = 0; offset < size;)
+        {
+            if (result.codeMap[offset])
+            {
+                ++offset;
+                continue;
+            }
+
+            const unsigned int start = offset;
+            while (offset < size && !result.codeMap[offset])
+            {
+                ++offset;
+            }
+
+            result.data.push_back({static_cast<uint16_t>(START_ADDRESS + start), static_cast<uint16_t>(START_ADDRESS + offset)});
+        }
+
+        return result;
+    }
+
+    /**
+     * Track I through each block (Annn / F000 set it, anything else that moves it makes it unknown)
+     * and flag writes whose range lands on code.
+     */
+    void FindSelfModifyingWrites(RomAnalysis& result) const
+    {
+        for (BasicBlock const& block : result.blocks)
+        {
+            bool known = false;
+            unsigned int index = 0;
+
+            for (unsigned int address = block.start; address < block.end; address = Next(address))
+            {
+                const uint16_t opcode = Opcode(address);
+                const Op op = DecodeOp(opcode);
+
+                if (op == Op::OP_Annn)
+                {
+                    known = true;
+                    index = opcode & 0x0FFFu;
+                }
+                else if (op == Op::OP_F000)
+                {
+                    known = true;
+                    index = Opcode(address + 2);
+                }
+                else if (op == Op::OP_Fx1E || op == Op::OP_Fx29 || op == Op::OP_Fx30)
+                {
+                    known = false;
+                }
+                else if (known && (OpFlags(op) & OP_MEM_WRITE))
+                {
+                    const unsigned int span = OpMemorySpan(op, opcode);
+
+                    for (unsigned int i = 0; i < span; ++i)
+                    {
+                        if (result.IsCode(static_cast<uint16_t>(index + i)))
+                        {
+                            result.selfModifying.push_back(static_cast<uint16_t>(address));
+                            result.codeWrites.push_back({static_cast<uint16_t>(index), static_cast<uint16_t>(index + span)});
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * Analyze a ROM image as it would be loaded at START_ADDRESS.
+     */
+    static RomAnalysis Analyze(uint8_t const* rom, size_t size)
+    {
+        return Analyzer(rom, size).Run();
+    }
+};
+
+#endif //ANALYZER_CPP
@@ -0,0 +1,377 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ASSEMBLER_CPP
+#define ASSEMBLER_CPP
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Chip8.h"
+#include "Opcodes.h"
+
+/**
+ * Two-pass assembler for the core's own instruction names.
+ *
+ *     loop:   OP_6xkk V0, 0x10      ; mnemonic is the handler name, "OP_" optional
+ *             OP_Annn sprite        ; operands fill x, y, n, kk, nnn in pattern order
+ *             OP_Dxyn V0, V1, 5
+ *             OP_1nnn loop
+ *     sprite: db 0xF0, 0x90, 0xF0   ; raw bytes, dw for big-endian words
+ *
+ * Numbers are decimal, 0x or $ hex, or 0b binary. A register may be written Vx.
+ * Labels stand for their address anywhere a number does.
+ */
+class Assembler
+{
+    struct Field
+    {
+        unsigned int shift;
+        unsigned int bits;
+    };
+
+    struct Encoding
+    {
+        uint16_t base{};
+        std::vector<Field> fields;
+        // F000 nnnn carries a 16-bit address after the opcode
+        bool longOperand{};
+    };
+
+    struct Line
+    {
+        unsigned int number{};
+        std::string label;
+        std::string mnemonic;
+        std::vector<std::string> operands;
+    };
+
+    std::unordered_map<std::string, Encoding> encodings;
+    std::unordered_map<std::string, uint32_t> labels;
+    std::string error;
+
+    /**
+     * Derive an instruction's encoding from its handler name, e.g. "6xkk" is 0x6000 | x << 8 | kk.
+     */
+    static Encoding MakeEncoding(char const* pattern)
+    {
+        Encoding encoding;
+
+        for (unsigned int i = 0; i < 4;)
+        {
+            const char c = pattern[i];
+            const unsigned int shift = 12 - 4 * i;
+
+            if (std::isxdigit(static_cast<unsigned char>(c)) && !std::islower(static_cast<unsigned char>(c)))
+            {
+                encoding.base |= std::strtoul(std::string(1, c).c_str(), nullptr, 16) << shift;
+                ++i;
+                continue;
+            }
+
+            unsigned int run = 1;
+            while (i + run < 4 && pattern[i + run] == c)
+            {
+                ++run;
+            }
+            encoding.fields.push_back(Field{shift - 4 * (run - 1), 4 * run});
+            i += run;
+        }
+
+        return encoding;
+    }
+
+    static std::string Trim(std::string const& text)
+    {
+        const size_t first = text.find_first_not_of(" \t\r");
+        const size_t last = text.find_last_not_of(" \t\r");
+        return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+    }
+
+    bool Fail(Line const& line, std::string const& message)
+    {
+        error = "line " + std::to_string(line.number) + ": " + message;
+        return false;
+    }
+
+    static void Parse(std::string const& source, std::vector<Line>& lines)
+    {
+        unsigned int number = 0;
+
+        for (size_t start = 0; start <= source.size();)
+        {
+            size_t end = source.find('\n', start);
+            if (end == std::string::npos)
+            {
+                end = source.size();
+            }
+
+            std::string text = source.substr(start, end - start);
+            start = end + 1;
+            ++number;
+
+            if (const size_t comment = text.find(';'); comment != std::string::npos)
+            {
+                text.resize(comment);
+            }
+
+            Line line;
+            line.number = number;
+            if (const size_t colon = text.find(':'); colon != std::string::npos)
+            {
+                line.label = Trim(text.substr(0, colon));
+                text = text.substr(colon + 1);
+            }
+
+            text = Trim(text);
+            const size_t space = text.find_first_of(" \t");
+            line.mnemonic = text.substr(0, space);
+
+            if (space != std::string::npos)
+            {
+                std::string operands = text.substr(space + 1);
+                for (size_t from = 0; from <= operands.size();)
+                {
+                    size_t comma = operands.find(',', from);
+                    if (comma == std::string::npos)
+                    {
+                        comma = operands.size();
+                    }
+                    if (std::string operand = Trim(operands.substr(from, comma - from)); !operand.empty())
+                    {
+                        line.operands.push_back(operand);
+                    }
+                    from = comma + 1;
+                }
+            }
+
+            if (!line.label.empty() || !line.mnemonic.empty())
+            {
+                lines.push_back(line);
+            }
+        }
+    }
+
+    bool Value(Line const& line, std::string const& text, uint32_t& value)
+    {
+        // Labels first, VBlank or V1sprite would otherwise read as registers
+        if (auto label = labels.find(text); label != labels.end())
+        {
+            value = label->second;
+            return true;
+        }
+
+        std::string digits = text;
+        int base = 10;
+
+        if (digits.size() > 1 && (digits[0] == 'V' || digits[0] == 'v') && std::isxdigit(static_cast<unsigned char>(digits[1])))
+        {
+            digits = digits.substr(1);
+            base = 16;
+        }
+        else if (digits.rfind("0x", 0) == 0 || digits.rfind("0X", 0) == 0)
+        {
+            digits = digits.substr(2);
+            base = 16;
+        }
+        else if (digits.rfind('$', 0) == 0)
+        {
+            digits = digits.substr(1);
+            base = 16;
+        }
+        else if (digits.rfind("0b", 0) == 0)
+        {
+            digits = digits.substr(2);
+            base = 2;
+        }
+
+        char* end = nullptr;
+        value = std::strtoul(digits.c_str(), &end, base);
+        if (digits.empty() || *end != '\0')
+        {
+            return Fail(line, "bad operand \"" + text + "\"");
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] Encoding const* Find(std::string const& mnemonic) const
+    {
+        auto encoding = encodings.find(mnemonic.rfind("OP_", 0) == 0 ? mnemonic.substr(3) : mnemonic);
+        return encoding == encodings.end() ? nullptr : &encoding->second;
+    }
+
+    /**
+     * Bytes a line takes up, known in the first pass without resolving labels.
+     */
+    bool Size(Line const& line, uint32_t& size)
+    {
+        if (line.mnemonic.empty())
+        {
+            size = 0;
+        }
+        else if (line.mnemonic == "db")
+        {
+            size = line.operands.size();
+        }
+        else if (line.mnemonic == "dw")
+        {
+            size = 2 * line.operands.size();
+        }
+        else if (Encoding const* encoding = Find(line.mnemonic))
+        {
+            size = encoding->longOperand ? 4 : 2;
+        }
+        else
+        {
+            return Fail(line, "unknown instruction \"" + line.mnemonic + "\"");
+        }
+
+        return true;
+    }
+
+    bool Emit(Line const& line, std::vector<uint8_t>& rom)
+    {
+        if (line.mnemonic.empty())
+        {
+            return true;
+        }
+
+        if (line.mnemonic == "db" || line.mnemonic == "dw")
+        {
+            const bool words = line.mnemonic == "dw";
+            for (std::string const& operand : line.operands)
+            {
+                uint32_t value;
+                if (!Value(line, operand, value))
+                {
+                    return false;
+                }
+                if (value >> (words ? 16u : 8u))
+                {
+                    return Fail(line, "operand \"" + operand + "\" does not fit in " + (words ? "16" : "8") + " bits");
+                }
+                if (words)
+                {
+                    rom.push_back(value >> 8u);
+                }
+                rom.push_back(value & 0xFFu);
+            }
+            return true;
+        }
+
+        Encoding const* encoding = Find(line.mnemonic);
+        const size_t expected = encoding->fields.size() + encoding->longOperand;
+        if (line.operands.size() != expected)
+        {
+            return Fail(line, line.mnemonic + " takes " + std::to_string(expected) + " operands");
+        }
+
+        uint16_t opcode = encoding->base;
+        for (size_t i = 0; i < encoding->fields.size(); ++i)
+        {
+            uint32_t value;
+            if (!Value(line, line.operands[i], value))
+            {
+                return false;
+            }
+            if (value >> encoding->fields[i].bits)
+            {
+                return Fail(line, "operand \"" + line.operands[i] + "\" does not fit in " +
+                                  std::to_string(encoding->fields[i].bits) + " bits");
+            }
+            opcode |= value << encoding->fields[i].shift;
+        }
+
+        rom.push_back(opcode >> 8u);
+        rom.push_back(opcode & 0xFFu);
+
+        if (encoding->longOperand)
+        {
+            uint32_t address;
+            if (!Value(line, line.operands.back(), address))
+            {
+                return false;
+            }
+            if (address >> 16u)
+            {
+                return Fail(line, "operand \"" + line.operands.back() + "\" does not fit in 16 bits");
+            }
+            rom.push_back((address >> 8u) & 0xFFu);
+            rom.push_back(address & 0xFFu);
+        }
+
+        return true;
+    }
+
+public:
+    Assembler()
+    {
+        for (unsigned int i = 1; i < static_cast<unsigned int>(Op::TABLE0); ++i)
+        {
+            const Op op = static_cast<Op>(i);
+            char const* name = OpName(op) + 3;
+
+            Encoding encoding = MakeEncoding(name);
+            encoding.longOperand = op == Op::OP_F000;
+            encodings[name] = encoding;
+        }
+    }
+
+    /**
+     * Assemble source into a ROM image that loads at START_ADDRESS.
+     * @return false with Error() set on the first bad line
+     */
+    bool Assemble(std::string const& source, std::vector<uint8_t>& rom)
+    {
+        std::vector<Line> lines;
+        labels.clear();
+        rom.clear();
+        error.clear();
+
+        Parse(source, lines);
+
+        uint32_t address = START_ADDRESS;
+        for (Line const& line : lines)
+        {
+            if (!line.label.empty() && !labels.emplace(line.label, address).second)
+            {
+                return Fail(line, "label \"" + line.label + "\" defined twice");
+            }
+
+            uint32_t size = 0;
+            if (!Size(line, size))
+            {
+                return false;
+            }
+            address += size;
+        }
+
+        for (Line const& line : lines)
+        {
+            if (!Emit(line, rom))
+            {
+                return false;
+            }
+        }
+
+        if (rom.size() > MAX_ROM_SIZE)
+        {
+            error = "program does not fit in memory";
+            return false;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] std::string const& Error() const
+    {
+        return error;
+    }
+};
+
+#endif //ASSEMBLER_CPP
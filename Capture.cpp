@@ -0,0 +1,330 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef CAPTURE_CPP
+#define CAPTURE_CPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Chip8.h"
+#include "Video.cpp"
+
+constexpr unsigned int CAPTURE_QUEUE_SIZE = 256;
+
+enum class CaptureFormat
+{
+    Y4M, // one streaming .y4m file, 60 fps, 4:4:4
+    PPM  // numbered .ppm files plus a frames.txt listing which file each frame shows
+};
+
+/**
+ * Writes presented frames to disk on a background thread.
+ * Frames are queued packed (2 KB each) and expanded on the writer thread,
+ * so the emulator only pays for a copy. Identical frames, spotted through
+ * the frame hash, are queued as a marker and never copied or re-encoded.
+ * Output is always 128x64 times the scale, low resolution frames are doubled.
+ */
+class FrameCapture
+{
+    struct Frame
+    {
+        uint64_t video[VIDEO_PLANES][HIRES_VIDEO_HEIGHT][VIDEO_ROW_WORDS];
+        bool hires;
+        bool duplicate;
+    };
+
+    CaptureFormat format;
+    std::string path;
+    unsigned int scale;
+    uint32_t palette[4] = {0x000000FF, 0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF};
+
+    // Ring buffer shared with the writer thread
+    std::vector<Frame> queue;
+    size_t head{};
+    size_t count{};
+    bool stopping{};
+    std::mutex lock;
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::thread writer;
+
+    bool hasLast{};
+    uint64_t lastHash{};
+
+    // Writer thread only
+    FILE* stream{};
+    FILE* manifest{};
+    std::vector<uint8_t> encoded;
+    std::string lastFile;
+    unsigned int frameNumber{};
+    unsigned int fileNumber{};
+
+    [[nodiscard]] unsigned int Width() const { return HIRES_VIDEO_WIDTH * scale; }
+    [[nodiscard]] unsigned int Height() const { return HIRES_VIDEO_HEIGHT * scale; }
+
+    /**
+     * Packed frame to RGB, scaled up to the output size.
+     */
+    void Rasterize(Frame const& frame, std::vector<uint8_t>& rgb) const
+    {
+        const unsigned int sourceWidth = frame.hires ? HIRES_VIDEO_WIDTH : VIDEO_WIDTH;
+        const unsigned int factor = frame.hires ? scale : scale * 2;
+        uint32_t row[HIRES_VIDEO_WIDTH];
+
+        rgb.resize(static_cast<size_t>(Width()) * Height() * 3);
+
+        for (unsigned int y = 0; y < Height(); ++y)
+        {
+            const unsigned int sourceY = y / factor;
+            ExpandRow(frame.video[0][sourceY], frame.video[1][sourceY], sourceWidth, palette, row);
+
+            uint8_t* out = &rgb[static_cast<size_t>(y) * Width() * 3];
+            for (unsigned int x = 0; x < Width(); ++x)
+            {
+                const uint32_t color = row[x / factor];
+                out[3 * x] = color >> 24u;
+                out[3 * x + 1] = (color >> 16u) & 0xFFu;
+                out[3 * x + 2] = (color >> 8u) & 0xFFu;
+            }
+        }
+    }
+
+    /**
+     * RGB to planar BT.601 YCbCr 4:4:4, the whole Y4M frame including its header.
+     */
+    void EncodeY4M(std::vector<uint8_t> const& rgb)
+    {
+        static constexpr char header[] = "FRAME\n";
+        const size_t pixels = static_cast<size_t>(Width()) * Height();
+
+        encoded.resize(sizeof(header) - 1 + pixels * 3);
+        memcpy(encoded.data(), header, sizeof(header) - 1);
+
+        uint8_t* planeY = encoded.data() + sizeof(header) - 1;
+        uint8_t* planeCb = planeY + pixels;
+        uint8_t* planeCr = planeCb + pixels;
+
+        for (size_t i = 0; i < pixels; ++i)
+        {
+            const int r = rgb[3 * i];
+            const int g = rgb[3 * i + 1];
+            const int b = rgb[3 * i + 2];
+
+            planeY[i] = static_cast<uint8_t>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            planeCb[i] = static_cast<uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            planeCr[i] = static_cast<uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+    }
+
+    void Write(Frame const& frame)
+    {
+        if (format == CaptureFormat::Y4M)
+        {
+            // A repeated frame is the previous encoding written again
+            if (!frame.duplicate || encoded.empty())
+            {
+                std::vector<uint8_t> rgb;
+                Rasterize(frame, rgb);
+                EncodeY4M(rgb);
+            }
+
+            fwrite(encoded.data(), 1, encoded.size(), stream);
+        }
+        else
+        {
+            if (!frame.duplicate || lastFile.empty())
+            {
+                std::vector<uint8_t> rgb;
+                Rasterize(frame, rgb);
+
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%06u.ppm", fileNumber++);
+                lastFile = name;
+
+                if (FILE* file = std::fopen((path + "/" + lastFile).c_str(), "wb"))
+                {
+                    std::fprintf(file, "P6\n%u %u\n255\n", Width(), Height());
+                    fwrite(rgb.data(), 1, rgb.size(), file);
+                    std::fclose(file);
+                }
+            }
+
+            std::fprintf(manifest, "%u %s%s\n", frameNumber, lastFile.c_str(), frame.duplicate ? " dup" : "");
+        }
+
+        ++frameNumber;
+    }
+
+    void WriterLoop()
+    {
+        while (true)
+        {
+            std::unique_lock guard(lock);
+            ready.wait(guard, [this] { return count > 0 || stopping; });
+
+            if (count == 0)
+            {
+                return;
+            }
+
+            // The slot stays ours until count drops, the producer never touches it
+            Frame const& frame = queue[head];
+            guard.unlock();
+
+            Write(frame);
+
+            guard.lock();
+            head = (head + 1) % queue.size();
+            --count;
+            guard.unlock();
+            space.notify_one();
+        }
+    }
+
+    Frame* Reserve(bool wait)
+    {
+        std::unique_lock guard(lock);
+
+        if (wait)
+        {
+            space.wait(guard, [this] { return count < queue.size(); });
+        }
+        else if (count == queue.size())
+        {
+            return nullptr;
+        }
+
+        return &queue[(head + count) % queue.size()];
+    }
+
+    void Commit()
+    {
+        {
+            std::lock_guard guard(lock);
+            ++count;
+        }
+        ready.notify_one();
+    }
+
+    bool Push(Chip8State const& state, bool wait)
+    {
+        const uint64_t hash = state.frameHash ^ state.hires;
+        const bool duplicate = hasLast && hash == lastHash;
+
+        Frame* frame = Reserve(wait);
+        if (!frame)
+        {
+            ++dropped;
+            return false;
+        }
+
+        frame->duplicate = duplicate;
+        frame->hires = state.hires;
+        if (!duplicate)
+        {
+            memcpy(frame->video, state.video, sizeof(frame->video));
+        }
+
+        hasLast = true;
+        lastHash = hash;
+        duplicate ? ++duplicates : ++unique;
+
+        Commit();
+        return true;
+    }
+
+public:
+    unsigned int unique{};
+    unsigned int duplicates{};
+    unsigned int dropped{};
+
+    /**
+     * @param path .y4m file to create, or an existing directory for PPM frames
+     * @param scale integer upscale of the 128x64 base size
+     */
+    FrameCapture(std::string path, CaptureFormat format, unsigned int scale)
+        : format(format), path(std::move(path)), scale(scale ? scale : 1), queue(CAPTURE_QUEUE_SIZE)
+    {
+        if (format == CaptureFormat::Y4M)
+        {
+            stream = std::fopen(this->path.c_str(), "wb");
+            if (stream)
+            {
+                std::fprintf(stream, "YUV4MPEG2 W%u H%u F60:1 Ip A1:1 C444\n", Width(), Height());
+            }
+        }
+        else
+        {
+            manifest = std::fopen((this->path + "/frames.txt").c_str(), "w");
+        }
+
+        if (IsOpen())
+        {
+            writer = std::thread(&FrameCapture::WriterLoop, this);
+        }
+    }
+
+    ~FrameCapture()
+    {
+        {
+            std::lock_guard guard(lock);
+            stopping = true;
+        }
+        ready.notify_one();
+
+        if (writer.joinable())
+        {
+            writer.join();
+        }
+        if (stream)
+        {
+            std::fclose(stream);
+        }
+        if (manifest)
+        {
+            std::fclose(manifest);
+        }
+    }
+
+    FrameCapture(FrameCapture const&) = delete;
+    FrameCapture& operator=(FrameCapture const&) = delete;
+
+    [[nodiscard]] bool IsOpen() const { return stream || manifest; }
+
+    /**
+     * Set before the first frame is submitted, the writer thread reads it unlocked.
+     */
+    void SetPalette(uint32_t const* colors, int colorCount)
+    {
+        palette[0] = colors[0];
+        palette[1] = colors[1];
+        palette[2] = colorCount >= 4 ? colors[2] : colors[1];
+        palette[3] = colorCount >= 4 ? colors[3] : colors[1];
+    }
+
+    /**
+     * Queue a frame without ever waiting, for real-time use.
+     * @return false if the queue was full and the frame was dropped
+     */
+    bool TrySubmit(Chip8State const& state)
+    {
+        return Push(state, false);
+    }
+
+    /**
+     * Queue a frame, waiting for room if the writer is behind (headless runs).
+     */
+    void Submit(Chip8State const& state)
+    {
+        Push(state, true);
+    }
+};
+
+#endif //CAPTURE_CPP
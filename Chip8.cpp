@@ -2,153 +2,573 @@
 // Created by _edd.ie_ on 23/06/2024.
 //
 
+#ifndef CHIP8_CPP
+#define CHIP8_CPP
+
+#include <algorithm>
+#include <bit>
 #include <cstdint>
-#include <fstream>
 #include <chrono>
 #include <random>
+#include <cstdlib>
 #include <cstring>
 #include "Chip8.h"
+#include "MappedFile.cpp"
+#include "Opcodes.h"
+#include "Timing.h"
 
-class Chip8
+class Chip8 : public Chip8State
 {
-    std::default_random_engine randGen;
     std::uniform_int_distribution<uint8_t> randByte;
 
     typedef void (Chip8::*Chip8Func)();
     Chip8Func table[0xF + 1]{};
-    Chip8Func table0[0xE + 1]{};
-    Chip8Func table8[0xE + 1]{};
-    Chip8Func tableE[0xE + 1]{};
-    Chip8Func tableF[0x65 + 1]{};
+    Chip8Func table0[0xFF + 1]{};
+    Chip8Func table5[0xF + 1]{};
+    Chip8Func table8[0xF + 1]{};
+    Chip8Func tableE[0xF + 1]{};
+    Chip8Func tableF[0xFF + 1]{};
 
 public:
-    uint8_t registers[16]{};
-    uint8_t memory[4096]{};
-    uint16_t index{};
-    uint16_t pc{};
-    uint16_t stack[16]{};
-    uint8_t sp{};
-    uint8_t delayTimer{};
-    uint8_t soundTimer{};
-    uint8_t keypad[16]{};
-    uint32_t video[64 * 32]{};
-    uint16_t opcode{};
+    Chip8()
+    {
+        // Initialize RNG
+        randGen.seed(std::chrono::system_clock::now().time_since_epoch().count());
+        randByte = std::uniform_int_distribution<uint8_t>(0, 255U);
+
+        Reset();
+
+        // Set up function pointer tables from the shared decode tables
+        for (size_t i = 0; i <= 0xF; i++)
+        {
+            table[i] = Handler(OPCODE_TABLES.table[i]);
+            table5[i] = Handler(OPCODE_TABLES.table5[i]);
+            table8[i] = Handler(OPCODE_TABLES.table8[i]);
+            tableE[i] = Handler(OPCODE_TABLES.tableE[i]);
+        }
+
+        for (size_t i = 0; i <= 0xFF; i++)
+        {
+            table0[i] = Handler(OPCODE_TABLES.table0[i]);
+            tableF[i] = Handler(OPCODE_TABLES.tableF[i]);
+        }
 
+    }
 
+    /**
+     * Member function that executes a decoded instruction.
+     * Sub-table entries map to the functions that dispatch into those tables.
+     */
+    static Chip8Func Handler(Op op)
+    {
+        switch (op)
+        {
+            case Op::OP_00Cn: return &Chip8::OP_00Cn;
+            case Op::OP_00Dn: return &Chip8::OP_00Dn;
+            case Op::OP_00E0: return &Chip8::OP_00E0;
+            case Op::OP_00EE: return &Chip8::OP_00EE;
+            case Op::OP_00FB: return &Chip8::OP_00FB;
+            case Op::OP_00FC: return &Chip8::OP_00FC;
+            case Op::OP_00FD: return &Chip8::OP_00FD;
+            case Op::OP_00FE: return &Chip8::OP_00FE;
+            case Op::OP_00FF: return &Chip8::OP_00FF;
+            case Op::OP_1nnn: return &Chip8::OP_1nnn;
+            case Op::OP_2nnn: return &Chip8::OP_2nnn;
+            case Op::OP_3xkk: return &Chip8::OP_3xkk;
+            case Op::OP_4xkk: return &Chip8::OP_4xkk;
+            case Op::OP_5xy0: return &Chip8::OP_5xy0;
+            case Op::OP_5xy2: return &Chip8::OP_5xy2;
+            case Op::OP_5xy3: return &Chip8::OP_5xy3;
+            case Op::OP_6xkk: return &Chip8::OP_6xkk;
+            case Op::OP_7xkk: return &Chip8::OP_7xkk;
+            case Op::OP_8xy0: return &Chip8::OP_8xy0;
+            case Op::OP_8xy1: return &Chip8::OP_8xy1;
+            case Op::OP_8xy2: return &Chip8::OP_8xy2;
+            case Op::OP_8xy3: return &Chip8::OP_8xy3;
+            case Op::OP_8xy4: return &Chip8::OP_8xy4;
+            case Op::OP_8xy5: return &Chip8::OP_8xy5;
+            case Op::OP_8xy6: return &Chip8::OP_8xy6;
+            case Op::OP_8xy7: return &Chip8::OP_8xy7;
+            case Op::OP_8xyE: return &Chip8::OP_8xyE;
+            case Op::OP_9xy0: return &Chip8::OP_9xy0;
+            case Op::OP_Annn: return &Chip8::OP_Annn;
+            case Op::OP_Bnnn: return &Chip8::OP_Bnnn;
+            case Op::OP_Cxkk: return &Chip8::OP_Cxkk;
+            case Op::OP_Dxyn: return &Chip8::OP_Dxyn;
+            case Op::OP_Ex9E: return &Chip8::OP_Ex9E;
+            case Op::OP_ExA1: return &Chip8::OP_ExA1;
+            case Op::OP_F000: return &Chip8::OP_F000;
+            case Op::OP_Fn01: return &Chip8::OP_Fn01;
+            case Op::OP_F002: return &Chip8::OP_F002;
+            case Op::OP_Fx07: return &Chip8::OP_Fx07;
+            case Op::OP_Fx0A: return &Chip8::OP_Fx0A;
+            case Op::OP_Fx15: return &Chip8::OP_Fx15;
+            case Op::OP_Fx18: return &Chip8::OP_Fx18;
+            case Op::OP_Fx1E: return &Chip8::OP_Fx1E;
+            case Op::OP_Fx29: return &Chip8::OP_Fx29;
+            case Op::OP_Fx30: return &Chip8::OP_Fx30;
+            case Op::OP_Fx33: return &Chip8::OP_Fx33;
+            case Op::OP_Fx3A: return &Chip8::OP_Fx3A;
+            case Op::OP_Fx55: return &Chip8::OP_Fx55;
+            case Op::OP_Fx65: return &Chip8::OP_Fx65;
+            case Op::OP_Fx75: return &Chip8::OP_Fx75;
+            case Op::OP_Fx85: return &Chip8::OP_Fx85;
+            case Op::TABLE0: return &Chip8::Table0;
+            case Op::TABLE5: return &Chip8::Table5;
+            case Op::TABLE8: return &Chip8::Table8;
+            case Op::TABLEE: return &Chip8::TableE;
+            case Op::TABLEF: return &Chip8::TableF;
+            case Op::OP_NULL:
+            case Op::COUNT: break;
+        }
 
+        return &Chip8::OP_NULL;
+    }
 
-    Chip8():randGen(std::chrono::system_clock::now().time_since_epoch().count())
+    /**
+     * Fonts in otherwise empty memory, built once and shared by every instance.
+     */
+    static PagedMemory<MEMORY_SIZE> const& BootMemory()
     {
+        static PagedMemory<MEMORY_SIZE> const boot = [] {
+            PagedMemory<MEMORY_SIZE> image;
+            image.Write(FONTSET_START_ADDRESS, fontset, FONTSET_SIZE);
+            image.Write(BIG_FONTSET_START_ADDRESS, bigFontset, BIG_FONTSET_SIZE);
+            image.Pin();
+            return image;
+        }();
+        return boot;
+    }
+
+    /**
+     * Power the machine back on in place: registers, stack, timers and display cleared,
+     * memory back to the fonts alone and pc at START_ADDRESS, ready for LoadROM.
+     * Settings chosen by the front end (the display-wait quirk), the persistent SCHIP flag
+     * registers and the random sequence carry on, and the dispatch tables are left alone.
+     */
+    void Reset()
+    {
+        const bool keepDisplayWait = displayWait;
+        uint8_t keepFlags[FLAG_REGISTER_COUNT];
+        memcpy(keepFlags, flags, sizeof(keepFlags));
+        const std::default_random_engine keepRandGen = randGen;
+
+        static_cast<Chip8State&>(*this) = Chip8State{};
+
+        displayWait = keepDisplayWait;
+        memcpy(flags, keepFlags, sizeof(flags));
+        randGen = keepRandGen;
+
         //Initialize the program counter
-        pc=START_ADDRESS;
+        pc = START_ADDRESS;
 
-        // Initialize RNG
-        randByte = std::uniform_int_distribution<uint8_t>(0, 255U);
+        // Fonts come from pages shared by every instance
+        memory = BootMemory();
+
+        // Square wave until a ROM loads its own pattern, so plain CHIP-8 still beeps
+        memset(audioPattern, 0xFF, AUDIO_PATTERN_SIZE / 2);
+
+        RehashRows(0, HIRES_VIDEO_HEIGHT);
+    }
+
+    /**
+     * Loading ROM content
+     * The file is mapped and copied straight into memory, no intermediate buffer.
+     * @param filename rom
+     */
+    void LoadROM(char const* filename)
+    {
+        if (const MappedFile file(filename); file.IsOpen())
+        {
+            LoadROM(file.Data(), file.Size());
+        }
+    }
 
-        // Load fonts into memory
-        for (unsigned int i = 0; i < FONTSET_SIZE; ++i)
+    /**
+     * Loading ROM content from a buffer.
+     * Anything past MAX_ROM_SIZE does not fit in memory and is dropped.
+     * @param data rom bytes
+     * @param size number of bytes
+     */
+    void LoadROM(uint8_t const* data, size_t size)
+    {
+        if (size > MAX_ROM_SIZE)
+        {
+            size = MAX_ROM_SIZE;
+        }
+
+        // Load the ROM contents into the Chip8's memory, starting at 0x200
+        if (size > 0)
         {
-            memory[FONTSET_START_ADDRESS + i] = fontset[i];
+            memory.Write(START_ADDRESS, data, size);
         }
+    }
+
+    /**
+     * Copy the machine state out, e.g. before running ahead.
+     */
+    void SaveState(Chip8State& snapshot) const
+    {
+        snapshot = *this;
+    }
 
+    /**
+     * Put the machine back to a state taken with SaveState.
+     */
+    void LoadState(Chip8State const& snapshot)
+    {
+        static_cast<Chip8State&>(*this) = snapshot;
+    }
 
-        // Set up function pointer table
-        table[0x0] = &Chip8::Table0;
-        table[0x1] = &Chip8::OP_1nnn;
-        table[0x2] = &Chip8::OP_2nnn;
-        table[0x3] = &Chip8::OP_3xkk;
-        table[0x4] = &Chip8::OP_4xkk;
-        table[0x5] = &Chip8::OP_5xy0;
-        table[0x6] = &Chip8::OP_6xkk;
-        table[0x7] = &Chip8::OP_7xkk;
-        table[0x8] = &Chip8::Table8;
-        table[0x9] = &Chip8::OP_9xy0;
-        table[0xA] = &Chip8::OP_Annn;
-        table[0xB] = &Chip8::OP_Bnnn;
-        table[0xC] = &Chip8::OP_Cxkk;
-        table[0xD] = &Chip8::OP_Dxyn;
-        table[0xE] = &Chip8::TableE;
-        table[0xF] = &Chip8::TableF;
+    /**
+     * Copy out the CPU side of the state. Padding is zeroed so the copy can be hashed as bytes.
+     */
+    void SaveCpu(CpuState& cpu) const
+    {
+        memset(static_cast<void*>(&cpu), 0, sizeof(cpu));
+        memcpy(cpu.registers, registers, sizeof(cpu.registers));
+        cpu.index = index;
+        cpu.pc = pc;
+        memcpy(cpu.stack, stack, sizeof(cpu.stack));
+        cpu.sp = sp;
+        cpu.delayTimer = delayTimer;
+        cpu.soundTimer = soundTimer;
+        memcpy(cpu.flags, flags, sizeof(cpu.flags));
+        cpu.hires = hires;
+        cpu.exited = exited;
+        cpu.planes = planes;
+        cpu.pitch = pitch;
+        memcpy(cpu.audioPattern, audioPattern, sizeof(cpu.audioPattern));
+        cpu.cycleBalance = cycleBalance;
+        cpu.displayWait = displayWait;
+        cpu.vblank = vblank;
+        cpu.randGen = randGen;
+    }
 
-        for (size_t i = 0; i <= 0xE; i++)
+    void LoadCpu(CpuState const& cpu)
+    {
+        memcpy(registers, cpu.registers, sizeof(cpu.registers));
+        index = cpu.index;
+        pc = cpu.pc;
+        memcpy(stack, cpu.stack, sizeof(cpu.stack));
+        sp = cpu.sp;
+        delayTimer = cpu.delayTimer;
+        soundTimer = cpu.soundTimer;
+        memcpy(flags, cpu.flags, sizeof(cpu.flags));
+        hires = cpu.hires;
+        exited = cpu.exited;
+        planes = cpu.planes;
+        pitch = cpu.pitch;
+        memcpy(audioPattern, cpu.audioPattern, sizeof(cpu.audioPattern));
+        cycleBalance = cpu.cycleBalance;
+        displayWait = cpu.displayWait;
+        vblank = cpu.vblank;
+        randGen = cpu.randGen;
+    }
+
+    /**
+     * Start tracking writes afresh, the next SaveDelta covers only what happens after this.
+     */
+    void Checkpoint()
+    {
+        memory.ClearDirty();
+        dirtyRows = 0;
+    }
+
+    /**
+     * Record what changed since the last checkpoint and make this the new checkpoint.
+     * Costs the CPU copy plus the lines and rows actually written, not the whole state.
+     */
+    void SaveDelta(StateDelta& delta)
+    {
+        SaveCpu(delta.cpu);
+
+        delta.lines.clear();
+        delta.lineData.clear();
+        memory.ForEachDirtyLine([&](unsigned int line) {
+            const unsigned int offset = line << MEMORY_LINE_SHIFT;
+            uint8_t const* bytes = memory.Page(offset >> PAGE_SHIFT) + (offset & PAGE_OFFSET_MASK);
+            delta.lines.push_back(line);
+            delta.lineData.insert(delta.lineData.end(), bytes, bytes + MEMORY_LINE_SIZE);
+        });
+
+        delta.rows = dirtyRows;
+        delta.rowData.clear();
+        for (uint64_t bits = dirtyRows; bits; bits &= bits - 1)
         {
-            table0[i] = &Chip8::OP_NULL;
-            table8[i] = &Chip8::OP_NULL;
-            tableE[i] = &Chip8::OP_NULL;
+            const unsigned int row = std::countr_zero(bits);
+            for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+            {
+                delta.rowData.insert(delta.rowData.end(), video[plane][row], video[plane][row] + VIDEO_ROW_WORDS);
+            }
         }
 
-        table0[0x0] = &Chip8::OP_00E0;
-        table0[0xE] = &Chip8::OP_00EE;
+        Checkpoint();
+    }
 
-        table8[0x0] = &Chip8::OP_8xy0;
-        table8[0x1] = &Chip8::OP_8xy1;
-        table8[0x2] = &Chip8::OP_8xy2;
-        table8[0x3] = &Chip8::OP_8xy3;
-        table8[0x4] = &Chip8::OP_8xy4;
-        table8[0x5] = &Chip8::OP_8xy5;
-        table8[0x6] = &Chip8::OP_8xy6;
-        table8[0x7] = &Chip8::OP_8xy7;
-        table8[0xE] = &Chip8::OP_8xyE;
+    /**
+     * Move a machine at the delta's starting checkpoint to its end, e.g. replaying from a keyframe.
+     */
+    void ApplyDelta(StateDelta const& delta)
+    {
+        LoadCpu(delta.cpu);
 
-        tableE[0x1] = &Chip8::OP_ExA1;
-        tableE[0xE] = &Chip8::OP_Ex9E;
+        for (size_t i = 0; i < delta.lines.size(); ++i)
+        {
+            memory.Write(delta.lines[i] << MEMORY_LINE_SHIFT, &delta.lineData[i * MEMORY_LINE_SIZE], MEMORY_LINE_SIZE);
+        }
 
-        for (size_t i = 0; i <= 0x65; i++)
+        uint64_t const* words = delta.rowData.data();
+        for (uint64_t bits = delta.rows; bits; bits &= bits - 1)
         {
-            tableF[i] = &Chip8::OP_NULL;
+            const unsigned int row = std::countr_zero(bits);
+            for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane, words += VIDEO_ROW_WORDS)
+            {
+                memcpy(video[plane][row], words, sizeof(video[plane][row]));
+            }
+            RehashRows(row, row + 1);
         }
 
-        tableF[0x07] = &Chip8::OP_Fx07;
-        tableF[0x0A] = &Chip8::OP_Fx0A;
-        tableF[0x15] = &Chip8::OP_Fx15;
-        tableF[0x18] = &Chip8::OP_Fx18;
-        tableF[0x1E] = &Chip8::OP_Fx1E;
-        tableF[0x29] = &Chip8::OP_Fx29;
-        tableF[0x33] = &Chip8::OP_Fx33;
-        tableF[0x55] = &Chip8::OP_Fx55;
-        tableF[0x65] = &Chip8::OP_Fx65;
+        Checkpoint();
+    }
+
+    /**
+     * Width of the display in the current resolution
+     */
+    [[nodiscard]] unsigned int VideoWidth() const
+    {
+        return hires ? HIRES_VIDEO_WIDTH : VIDEO_WIDTH;
+    }
 
+    /**
+     * Height of the display in the current resolution
+     */
+    [[nodiscard]] unsigned int VideoHeight() const
+    {
+        return hires ? HIRES_VIDEO_HEIGHT : VIDEO_HEIGHT;
     }
 
     /**
-     * Loading ROM content
-     * @param filename rom
+     * Line up a sprite row of `width` bits (MSB = leftmost pixel) with column x,
+     * split across the two words of a display row.
+     * Pixels pushed past the right edge of the second word fall off.
      */
-    void LoadROM(char const* filename)
+    static void PlaceSpriteRow(uint64_t bits, unsigned int width, unsigned int x, uint64_t& left, uint64_t& right)
     {
-        // Open the file as a stream of binary and move the file pointer to the end
-        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        const uint64_t aligned = bits << (64u - width);
 
-        if (file.is_open())
+        if (x < 64)
+        {
+            left = aligned >> x;
+            right = x ? aligned << (64u - x) : 0;
+        }
+        else
         {
-            // Get size of file and allocate a buffer to hold the contents
-            std::streampos size = file.tellg();
-            char* buffer = new char[size];
+            left = 0;
+            right = aligned >> (x - 64u);
+        }
+    }
+
+    /**
+     * Skip the next instruction.
+     * F000 nnnn is four bytes long, so skipping it moves the pc twice as far.
+     */
+    void SkipNext()
+    {
+        const bool longLoad = memory[pc & MEMORY_MASK] == 0xF0 && memory[(pc + 1) & MEMORY_MASK] == 0x00;
+        pc += 2 + 2 * longLoad;
+    }
+
+    /**
+     * Hash of one display row, both planes, mixed with the row number
+     * so identical rows in different places don't cancel out in the frame hash.
+     */
+    [[nodiscard]] uint64_t HashRow(unsigned int row) const
+    {
+        uint64_t hash = (row + 1) * 0x9E3779B97F4A7C15ull;
+
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+        {
+            for (unsigned int word = 0; word < VIDEO_ROW_WORDS; ++word)
+            {
+                hash = (hash ^ video[plane][row][word]) * 0xFF51AFD7ED558CCDull;
+                hash ^= hash >> 32u;
+            }
+        }
+
+        return hash;
+    }
+
+    /**
+     * Refresh the hashes of rows [first, last) after they were written,
+     * swapping their old contribution to the frame hash for the new one.
+     */
+    void RehashRows(unsigned int first, unsigned int last)
+    {
+        for (unsigned int row = first; row < last; ++row)
+        {
+            const uint64_t hash = HashRow(row);
+            frameHash ^= rowHash[row] ^ hash;
+            rowHash[row] = hash;
+            dirtyRows |= 1ull << row;
+        }
+    }
+
+    /**
+     * Hash of the whole display, kept up to date by every instruction that draws.
+     * Equal frames have equal hashes, so comparing frames never needs a rescan.
+     */
+    [[nodiscard]] uint64_t FrameHash() const
+    {
+        return frameHash ^ hires;
+    }
 
-            // Go back to the beginning of the file and fill the buffer
-            file.seekg(0, std::ios::beg);
-            file.read(buffer, size);
-            file.close();
+    /**
+     * Scroll the selected planes vertically.
+     * @param rows positive moves the picture down, negative moves it up
+     */
+    void ScrollVertical(int rows)
+    {
+        const unsigned int height = VideoHeight();
+        const unsigned int n = std::min<unsigned int>(std::abs(rows), height);
+        const unsigned int moved = height - n;
 
-            // Load the ROM contents into the Chip8's memory, starting at 0x200
-            for (long i = 0; i < size; ++i)
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+        {
+            if (!(planes & (1u << plane)))
             {
-                memory[START_ADDRESS + i] = buffer[i];
+                continue;
             }
 
-            // Free the buffer
-            delete[] buffer;
+            auto& screen = video[plane];
+
+            if (rows > 0)
+            {
+                memmove(screen[n], screen[0], moved * sizeof(screen[0]));
+                memset(screen[0], 0, n * sizeof(screen[0]));
+            }
+            else
+            {
+                memmove(screen[0], screen[n], moved * sizeof(screen[0]));
+                memset(screen[moved], 0, n * sizeof(screen[0]));
+            }
         }
+
+        RehashRows(0, height);
     }
 
     //Instruction set
 
     /**
-     * Clear the display.
+     * Clear the selected planes.
      */
     void OP_00E0()
     {
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+        {
+            if (planes & (1u << plane))
+            {
+                memset(video[plane], 0, sizeof(video[plane]));
+            }
+        }
+
+        RehashRows(0, HIRES_VIDEO_HEIGHT);
+    }
+
+    /**
+     * Scroll the display down n rows.
+     * Whole rows are moved, the top n come in blank.
+     */
+    void OP_00Cn()
+    {
+        ScrollVertical(opcode & 0x000Fu);
+    }
+
+    /**
+     * Scroll the display up n rows.
+     */
+    void OP_00Dn()
+    {
+        ScrollVertical(-static_cast<int>(opcode & 0x000Fu));
+    }
+
+    /**
+     * Scroll the display right 4 pixels.
+     * Each row is shifted as one 128-bit value, anything past the right edge is dropped.
+     */
+    void OP_00FB()
+    {
+        const uint64_t rightMask = hires ? ~0ull : 0;
+
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+        {
+            if (!(planes & (1u << plane)))
+            {
+                continue;
+            }
+
+            for (unsigned int row = 0; row < VideoHeight(); ++row)
+            {
+                uint64_t* line = video[plane][row];
+                line[1] = ((line[1] >> 4u) | (line[0] << 60u)) & rightMask;
+                line[0] >>= 4u;
+            }
+        }
+
+        RehashRows(0, VideoHeight());
+    }
+
+    /**
+     * Scroll the display left 4 pixels.
+     */
+    void OP_00FC()
+    {
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+        {
+            if (!(planes & (1u << plane)))
+            {
+                continue;
+            }
+
+            for (unsigned int row = 0; row < VideoHeight(); ++row)
+            {
+                uint64_t* line = video[plane][row];
+                line[0] = (line[0] << 4u) | (line[1] >> 60u);
+                line[1] <<= 4u;
+            }
+        }
+
+        RehashRows(0, VideoHeight());
+    }
+
+    /**
+     * Exit the interpreter.
+     * Parks the pc on this instruction so further cycles do nothing.
+     */
+    void OP_00FD()
+    {
+        exited = true;
+        pc -= 2;
+    }
+
+    /**
+     * Switch to 64x32 low resolution and clear the display.
+     */
+    void OP_00FE()
+    {
+        hires = false;
         memset(video, 0, sizeof(video));
+        RehashRows(0, HIRES_VIDEO_HEIGHT);
+    }
+
+    /**
+     * Switch to 128x64 high resolution and clear the display.
+     */
+    void OP_00FF()
+    {
+        hires = true;
+        memset(video, 0, sizeof(video));
+        RehashRows(0, HIRES_VIDEO_HEIGHT);
     }
 
     /**
@@ -156,7 +576,9 @@ public:
      */
     void OP_00EE()
     {
-        pc = stack[--sp];
+        // sp is left free to under/overflow so callers can spot it,
+        // the slot itself is masked into the stack
+        pc = stack[--sp & STACK_MASK];
     }
 
     /**
@@ -175,7 +597,7 @@ public:
     {
         const uint16_t address = opcode & 0x0FFFu;
 
-        stack[sp++] = pc;
+        stack[sp++ & STACK_MASK] = pc;
         pc = address;
     }
 
@@ -189,7 +611,7 @@ public:
 
         if (registers[Vx] == byte)
         {
-            pc += 2;
+            SkipNext();
         }
     }
 
@@ -202,7 +624,7 @@ public:
 
         if (const uint8_t byte = opcode & 0x00FFu; registers[Vx] != byte)
         {
-            pc += 2;
+            SkipNext();
         }
     }
 
@@ -216,7 +638,38 @@ public:
 
         if (registers[Vx] == registers[Vy])
         {
-            pc += 2;
+            SkipNext();
+        }
+    }
+
+    /**
+     * Store registers Vx through Vy in memory starting at location I.
+     * Works in either direction and leaves I alone.
+     */
+    void OP_5xy2()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+        const uint8_t Vy = (opcode & 0x00F0u) >> 4u;
+        const int step = Vx <= Vy ? 1 : -1;
+
+        for (int i = 0, reg = Vx; i <= std::abs(Vy - Vx); ++i, reg += step)
+        {
+            memory.Write((index + i) & MEMORY_MASK, registers[reg]);
+        }
+    }
+
+    /**
+     * Read registers Vx through Vy from memory starting at location I.
+     */
+    void OP_5xy3()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+        const uint8_t Vy = (opcode & 0x00F0u) >> 4u;
+        const int step = Vx <= Vy ? 1 : -1;
+
+        for (int i = 0, reg = Vx; i <= std::abs(Vy - Vx); ++i, reg += step)
+        {
+            registers[reg] = memory[(index + i) & MEMORY_MASK];
         }
     }
 
@@ -393,7 +846,7 @@ public:
 
         if (registers[Vx] != registers[Vy])
         {
-            pc += 2;
+            SkipNext();
         }
     }
 
@@ -428,12 +881,13 @@ public:
     }
 
     /**
-    * Iterate over the sprite, row by row and column by column.
-    * 8 columns because sprite is 8px wide.
-    * If a sprite pixel is ON then there may be a collision with what’s already being displayed
-    * Check if our screen pixel in the same location is set.
-    * If so we must set the VF register to express collision.
-    * XOR the screen pixel with 0xFFFFFFFF to essentially XOR it with the sprite pixel
+    * The display is packed, so a whole sprite row is lined up with the
+    * screen row as a mask and XORed in one go, collision is any overlap.
+    * The start position wraps, anything drawn past the right or bottom edge is clipped.
+    * Dxy0 draws a 16x16 sprite (two bytes per row).
+    * In high resolution VF counts the rows that collided, as SUPER-CHIP does.
+    * With both planes selected the sprite data for the second plane
+    * follows straight after the data for the first.
     */
     void OP_Dxyn()
     {
@@ -441,35 +895,76 @@ public:
         const uint8_t Vy = (opcode & 0x00F0u) >> 4u;
         const uint8_t height = opcode & 0x000Fu;
 
+        // The VIP interpreter waited for the display interrupt before drawing,
+        // so a second sprite in the same frame stalls, pc rewound as in Fx0A, until the next one
+        if (displayWait)
+        {
+            if (!vblank)
+            {
+                pc -= 2;
+                waitingForVblank = true;
+                return;
+            }
+            vblank = false;
+        }
+
         // Wrap if going beyond screen boundaries
-        const uint8_t xPos = registers[Vx] % VIDEO_WIDTH;
-        const uint8_t yPos = registers[Vy] % VIDEO_HEIGHT;
+        const unsigned int xPos = registers[Vx] & (VideoWidth() - 1);
+        const unsigned int yPos = registers[Vy] & (VideoHeight() - 1);
+
+        const bool wide = height == 0;
+        const unsigned int spriteWidth = wide ? 16 : 8;
+        const unsigned int spriteHeight = wide ? 16 : height;
+        const unsigned int spriteBytes = wide ? 32 : height;
+
+        // Clip to the screen once, up front, rather than per row
+        const unsigned int rows = std::min<unsigned int>(spriteHeight, VideoHeight() - yPos);
 
-        registers[0xF] = 0;
+        // Low resolution only uses the first word of each row
+        const uint64_t rightMask = hires ? ~0ull : 0;
 
-        for (unsigned int row = 0; row < height; ++row)
+        unsigned int collisions = 0;
+        uint16_t address = index;
+
+        for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
         {
-            const uint8_t spriteByte = memory[index + row];
+            if (!(planes & (1u << plane)))
+            {
+                continue;
+            }
 
-            for (unsigned int col = 0; col < 8; ++col)
+            for (unsigned int row = 0; row < rows; ++row)
             {
-                const uint8_t spritePixel = spriteByte & (0x80u >> col);
-                uint32_t* screenPixel = &video[(yPos + row) * VIDEO_WIDTH + (xPos + col)];
+                uint64_t spriteBits;
 
-                // Sprite pixel is on
-                if (spritePixel)
+                if (wide)
+                {
+                    spriteBits = (memory[(address + 2 * row) & MEMORY_MASK] << 8u) | memory[(address + 2 * row + 1) & MEMORY_MASK];
+                }
+                else
                 {
-                    // Screen pixel also on - collision
-                    if (*screenPixel == 0xFFFFFFFF)
-                    {
-                        registers[0xF] = 1;
-                    }
-
-                    // Effectively XOR with the sprite pixel
-                    *screenPixel ^= 0xFFFFFFFF;
+                    spriteBits = memory[(address + row) & MEMORY_MASK];
                 }
+
+                uint64_t left, right;
+                PlaceSpriteRow(spriteBits, spriteWidth, xPos, left, right);
+                right &= rightMask;
+
+                uint64_t* line = video[plane][yPos + row];
+
+                // Screen pixels also on - collision
+                collisions += ((line[0] & left) | (line[1] & right)) != 0;
+
+                line[0] ^= left;
+                line[1] ^= right;
             }
+
+            address += spriteBytes;
         }
+
+        RehashRows(yPos, yPos + rows);
+
+        registers[0xF] = hires ? collisions : collisions != 0;
     }
 
     /**
@@ -478,9 +973,9 @@ public:
     void OP_Ex9E()
     {
         const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
-        if (const uint8_t key = registers[Vx]; keypad[key])
+        if (const uint8_t key = registers[Vx] & 0xFu; keypad[key])
         {
-            pc += 2;
+            SkipNext();
         }
     }
 
@@ -490,9 +985,37 @@ public:
     void OP_ExA1()
     {
         const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
-        if (const uint8_t key = registers[Vx]; !keypad[key])
+        if (const uint8_t key = registers[Vx] & 0xFu; !keypad[key])
         {
-            pc += 2;
+            SkipNext();
+        }
+    }
+
+    /**
+     * Set I = the 16-bit address that follows this instruction, then step over it.
+     */
+    void OP_F000()
+    {
+        index = (memory[pc & MEMORY_MASK] << 8u) | memory[(pc + 1) & MEMORY_MASK];
+        pc += 2;
+    }
+
+    /**
+     * Select the planes that drawing, clearing and scrolling apply to.
+     */
+    void OP_Fn01()
+    {
+        planes = ((opcode & 0x0F00u) >> 8u) & 0x3u;
+    }
+
+    /**
+     * Load the 16 byte audio pattern from memory starting at location I.
+     */
+    void OP_F002()
+    {
+        for (unsigned int i = 0; i < AUDIO_PATTERN_SIZE; ++i)
+        {
+            audioPattern[i] = memory[(index + i) & MEMORY_MASK];
         }
     }
 
@@ -627,6 +1150,17 @@ public:
         index = FONTSET_START_ADDRESS + (5 * digit);
     }
 
+    /**
+    * Set I = location of the 10 byte high resolution sprite for digit Vx.
+     */
+    void OP_Fx30()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+        const uint8_t digit = registers[Vx] & 0xFu;
+
+        index = BIG_FONTSET_START_ADDRESS + (10 * digit);
+    }
+
     /**
     * The interpreter takes the decimal value of Vx,
     * and places the hundreds digit in memory at location in I,
@@ -642,15 +1176,25 @@ public:
         uint8_t value = registers[Vx];
 
         // Ones-place
-        memory[index + 2] = value % 10;
+        memory.Write((index + 2) & MEMORY_MASK, value % 10);
         value /= 10;
 
         // Tens-place
-        memory[index + 1] = value % 10;
+        memory.Write((index + 1) & MEMORY_MASK, value % 10);
         value /= 10;
 
         // Hundreds-place
-        memory[index] = value % 10;
+        memory.Write(index & MEMORY_MASK, value % 10);
+    }
+
+    /**
+     * Set the audio pattern playback pitch = Vx.
+     * The pattern plays at 4000 * 2^((Vx - 64) / 48) bits per second.
+     */
+    void OP_Fx3A()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+        pitch = registers[Vx];
     }
 
     /**
@@ -662,7 +1206,7 @@ public:
 
         for (uint8_t i = 0; i <= Vx; ++i)
         {
-            memory[index + i] = registers[i];
+            memory.Write((index + i) & MEMORY_MASK, registers[i]);
         }
     }
 
@@ -675,7 +1219,33 @@ public:
 
         for (uint8_t i = 0; i <= Vx; ++i)
         {
-            registers[i] = memory[index + i];
+            registers[i] = memory[(index + i) & MEMORY_MASK];
+        }
+    }
+
+    /**
+     * Store registers V0 through Vx in the flag registers.
+     */
+    void OP_Fx75()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+
+        for (uint8_t i = 0; i <= Vx; ++i)
+        {
+            flags[i] = registers[i];
+        }
+    }
+
+    /**
+     * Read registers V0 through Vx from the flag registers.
+     */
+    void OP_Fx85()
+    {
+        const uint8_t Vx = (opcode & 0x0F00u) >> 8u;
+
+        for (uint8_t i = 0; i <= Vx; ++i)
+        {
+            registers[i] = flags[i];
         }
     }
 
@@ -683,7 +1253,12 @@ public:
     //Function pointer tables
     void Table0()
     {
-        ((this)->*(table0[opcode & 0x000Fu]))();
+        ((this)->*(table0[opcode & 0x00FFu]))();
+    }
+
+    void Table5()
+    {
+        ((this)->*(table5[opcode & 0x000Fu]))();
     }
 
     void Table8()
@@ -717,16 +1292,31 @@ public:
     * Use that as index into the function pointer array.
      */
     void Cycle()
+    {
+        Execute();
+        TickTimers();
+    }
+
+    /**
+     * One instruction without the timer tick, for callers that keep time themselves.
+     */
+    void Execute()
     {
         // Fetch
-        opcode = (memory[pc] << 8u) | memory[pc + 1];
+        opcode = (memory[pc & MEMORY_MASK] << 8u) | memory[(pc + 1) & MEMORY_MASK];
 
         // Increment the PC before we execute anything
         pc += 2;
 
         // Decode and Execute
         ((this)->*(table[(opcode & 0xF000u) >> 12u]))();
+    }
 
+    /**
+     * Per cycle timer update, shared with recompiled code so both count time the same way.
+     */
+    void TickTimers()
+    {
         // Decrement the delay timer if it's been set
         if (delayTimer > 0)
         {
@@ -740,5 +1330,96 @@ public:
         }
     }
 
+    /**
+     * Run a batch of cycles back to back, e.g. one frame's worth.
+     */
+    void RunFrame(unsigned int cycles)
+    {
+        for (unsigned int i = 0; i < cycles; ++i)
+        {
+            Cycle();
+
+            // Spinning on the stalled Dxyn would only tick the timers
+            if (waitingForVblank)
+            {
+                for (++i; i < cycles; ++i)
+                {
+                    TickTimers();
+                }
+            }
+        }
+
+        Vblank();
+    }
+
+    /**
+     * The 60 Hz interrupt at the end of every frame, releases a Dxyn held by the display-wait quirk.
+     */
+    void Vblank()
+    {
+        vblank = true;
+        waitingForVblank = false;
+    }
+
+    /**
+     * One 60 Hz frame of a COSMAC VIP: instructions run until their machine cycles use up
+     * what the display leaves of the frame, then the timers tick once, as on the real machine.
+     * An instruction that runs past the end is finished and its overrun comes off the next frame.
+     * @return instructions executed
+     */
+    unsigned int RunTimedFrame(TimingMode mode)
+    {
+        return RunTimedFrame(mode, [this]() { Execute(); });
+    }
+
+    /**
+     * RunTimedFrame with execute() standing in for Execute, for wrappers such as the profiler.
+     */
+    template <typename F>
+    unsigned int RunTimedFrame(TimingMode mode, F&& execute)
+    {
+        cycleBalance += VIP_PROGRAM_CYCLES;
+        unsigned int executed = 0;
+
+        while (cycleBalance > 0 && !exited)
+        {
+            const uint16_t next = (memory[pc & MEMORY_MASK] << 8u) | memory[(pc + 1) & MEMORY_MASK];
+            const Op op = DecodeOp(next);
+
+            uint8_t before[16];
+            const uint16_t start = pc;
+            if (mode == TimingMode::VipAccurate)
+            {
+                memcpy(before, registers, sizeof(before));
+            }
+
+            execute();
+
+            // The stalled Dxyn did not run, it is paid for when it draws after the vblank.
+            // The rest of the frame goes on waiting for the display
+            if (waitingForVblank)
+            {
+                cycleBalance = 0;
+                break;
+            }
+
+            if (mode == TimingMode::VipAccurate)
+            {
+                const bool skipped = (OpFlags(op) & OP_FLOW_SKIP) && static_cast<uint16_t>(pc - start) > 2;
+                cycleBalance -= static_cast<int32_t>(OpCyclesAccurate(op, next, before, skipped));
+            }
+            else
+            {
+                cycleBalance -= static_cast<int32_t>(OpCycles(op));
+            }
+            ++executed;
+        }
+
+        TickTimers();
+        Vblank();
+        return executed;
+    }
+
 };
 
+#endif //CHIP8_CPP
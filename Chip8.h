@@ -5,11 +5,33 @@
 #ifndef CHIP8_H
 #define CHIP8_H
 
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Memory.h"
+
+// XO-CHIP addresses the full 64 KB, plain CHIP-8 ROMs just never touch the upper part
+constexpr unsigned int MEMORY_SIZE = 65536;
+constexpr unsigned int MEMORY_MASK = MEMORY_SIZE - 1;
+constexpr unsigned int STACK_SIZE = 16;
+constexpr unsigned int STACK_MASK = STACK_SIZE - 1;
 constexpr unsigned int START_ADDRESS = 0x200;
+constexpr unsigned int MAX_ROM_SIZE = MEMORY_SIZE - START_ADDRESS;
 constexpr unsigned int FONTSET_SIZE = 80;
 constexpr unsigned int FONTSET_START_ADDRESS = 0x50;
+constexpr unsigned int BIG_FONTSET_SIZE = 160;
+constexpr unsigned int BIG_FONTSET_START_ADDRESS = FONTSET_START_ADDRESS + FONTSET_SIZE;
+constexpr unsigned int FLAG_REGISTER_COUNT = 16;
 constexpr unsigned int VIDEO_HEIGHT = 32;
 constexpr unsigned int VIDEO_WIDTH = 64;
+constexpr unsigned int HIRES_VIDEO_HEIGHT = 64;
+constexpr unsigned int HIRES_VIDEO_WIDTH = 128;
+// The display is packed one bit per pixel, leftmost pixel in the MSB of the first word
+constexpr unsigned int VIDEO_ROW_WORDS = HIRES_VIDEO_WIDTH / 64;
+constexpr unsigned int VIDEO_PLANE_WORDS = HIRES_VIDEO_HEIGHT * VIDEO_ROW_WORDS;
+constexpr unsigned int VIDEO_PLANES = 2;
+constexpr unsigned int AUDIO_PATTERN_SIZE = 16;
+constexpr uint8_t DEFAULT_AUDIO_PITCH = 64;
 
 inline uint8_t fontset[FONTSET_SIZE] = {
     0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
@@ -30,6 +52,105 @@ inline uint8_t fontset[FONTSET_SIZE] = {
     0xF0, 0x80, 0xF0, 0x80, 0x80  // F
 };
 
+// SUPER-CHIP 8x10 digits, A-F included
+inline uint8_t bigFontset[BIG_FONTSET_SIZE] = {
+    0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, // 0
+    0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, // 1
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // 2
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 3
+    0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 5
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 6
+    0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, // 7
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 8
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 9
+    0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, // A
+    0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, // B
+    0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C, // C
+    0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, // D
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // E
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0  // F
+};
+
+
+/**
+ * Everything that makes up the running machine, and nothing else.
+ * A snapshot or rollback is one copy, memory pages are shared copy-on-write so it stays cheap.
+ */
+struct Chip8State
+{
+    uint8_t registers[16]{};
+    PagedMemory<MEMORY_SIZE> memory;
+    uint16_t index{};
+    uint16_t pc{};
+    uint16_t stack[STACK_SIZE]{};
+    uint8_t sp{};
+    uint8_t delayTimer{};
+    uint8_t soundTimer{};
+    uint8_t keypad[16]{};
+    uint64_t video[VIDEO_PLANES][HIRES_VIDEO_HEIGHT][VIDEO_ROW_WORDS]{};
+    uint16_t opcode{};
+    uint8_t flags[FLAG_REGISTER_COUNT]{};
+    bool hires{};
+    bool exited{};
+    uint8_t planes{1};
+    uint8_t audioPattern[AUDIO_PATTERN_SIZE]{};
+    uint8_t pitch{DEFAULT_AUDIO_PITCH};
+    // Hash of each display row over both planes, and the XOR of them all
+    uint64_t rowHash[HIRES_VIDEO_HEIGHT]{};
+    uint64_t frameHash{};
+    // Bit n set when display row n changed since the last checkpoint
+    uint64_t dirtyRows{};
+    // Machine cycles a timed frame overran by, taken off the next frame's budget
+    int32_t cycleBalance{};
+    // Display-wait quirk: Dxyn draws at most once per frame, right after the vblank
+    bool displayWait{};
+    // No sprite drawn since the last vblank
+    bool vblank{true};
+    // A Dxyn is stalled until the next vblank, the frame loops stop early on it
+    bool waitingForVblank{};
+    // Part of the state so replaying from a snapshot gives the same random numbers
+    std::default_random_engine randGen;
+};
+
+/**
+ * Everything that decides what a machine does next, minus its memory and display.
+ * Kept apart so it can be hashed and copied in one go.
+ */
+struct CpuState
+{
+    uint8_t registers[16]{};
+    uint16_t index{};
+    uint16_t pc{};
+    uint16_t stack[STACK_SIZE]{};
+    uint8_t sp{};
+    uint8_t delayTimer{};
+    uint8_t soundTimer{};
+    uint8_t flags[FLAG_REGISTER_COUNT]{};
+    bool hires{};
+    bool exited{};
+    uint8_t planes{};
+    uint8_t pitch{};
+    uint8_t audioPattern[AUDIO_PATTERN_SIZE]{};
+    int32_t cycleBalance{};
+    bool displayWait{};
+    bool vblank{};
+    std::default_random_engine randGen;
+};
 
+/**
+ * What changed between two checkpoints: the CPU, the memory lines and the display rows written.
+ * Applied in order on top of the state at the first checkpoint it gives the state at the second.
+ * The vectors keep their capacity, so reusing a delta per frame does not allocate.
+ */
+struct StateDelta
+{
+    CpuState cpu;
+    std::vector<uint16_t> lines;
+    std::vector<uint8_t> lineData;
+    uint64_t rows{};
+    // Per dirty row, both planes
+    std::vector<uint64_t> rowData;
+};
 
 #endif //CHIP8_H
@@ -0,0 +1,255 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef COMPOSITOR_CPP
+#define COMPOSITOR_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "Chip8.h"
+#include "Video.cpp"
+
+// Frames the OR mode can remember
+constexpr unsigned int COMPOSITE_MAX_HISTORY = 8;
+
+/**
+ * How frames are combined before they are shown.
+ * Or: a pixel is lit if it was lit in any of the last K frames, sprites erased and redrawn
+ * by XOR stay solid.
+ * Phosphor: a lit pixel glows at full strength and fades by a fixed factor each frame,
+ * like the persistence of a CRT.
+ */
+enum class CompositeMode : uint8_t
+{
+    Off,
+    Or,
+    Phosphor
+};
+
+/**
+ * Flicker reduction between the core and the platform.
+ * Works on the display at its own resolution, 128x64 at most, so the cost does not grow
+ * with the window. The OR mode stays packed and feeds Platform::Update, the phosphor mode
+ * keeps an intensity per pixel and plane and writes RGBA for Platform::Present.
+ */
+class FrameCompositor
+{
+    CompositeMode mode;
+    unsigned int history;
+    // 0-256, the share of its glow a pixel keeps per frame
+    uint16_t persistence;
+
+    // Ring of the last frames, and their union
+    uint64_t frames[COMPOSITE_MAX_HISTORY][VIDEO_PLANES * VIDEO_PLANE_WORDS]{};
+    uint64_t combined[VIDEO_PLANES * VIDEO_PLANE_WORDS]{};
+    unsigned int next{};
+
+    uint16_t intensity[VIDEO_PLANES][HIRES_VIDEO_HEIGHT * HIRES_VIDEO_WIDTH]{};
+    uint32_t pixels[HIRES_VIDEO_HEIGHT * HIRES_VIDEO_WIDTH]{};
+
+    // Same default as Platform, RGBA8888 indexed by plane 0 bit | plane 1 bit << 1
+    uint32_t palette[4] = {0x000000FF, 0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF};
+
+    unsigned int width{};
+    unsigned int height{};
+
+    /**
+     * A resolution change starts from a clean history, old frames would be misplaced.
+     */
+    void Resize(unsigned int newWidth, unsigned int newHeight)
+    {
+        if (newWidth != width || newHeight != height)
+        {
+            width = newWidth;
+            height = newHeight;
+            memset(frames, 0, sizeof(frames));
+            memset(intensity, 0, sizeof(intensity));
+        }
+    }
+
+    /**
+     * Fade one row of intensities and relight the pixels set in it.
+     */
+    void DecayRow(uint64_t const* bits, uint16_t* row) const
+    {
+#ifdef CHIP8_VIDEO_SSE2
+        // Lane 0 is the leftmost pixel, the highest bit of the byte
+        const __m128i bitSelect = _mm_set_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m128i keep = _mm_set1_epi16(static_cast<short>(persistence));
+        const __m128i full = _mm_set1_epi16(255);
+
+        for (unsigned int x = 0; x < width; x += 8)
+        {
+            const auto byte = static_cast<short>((bits[x >> 6u] >> (56u - (x & 63u))) & 0xFFu);
+            const __m128i lit = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(byte), bitSelect), bitSelect);
+
+            auto* lanes = reinterpret_cast<__m128i*>(row + x);
+            const __m128i faded = _mm_srli_epi16(_mm_mullo_epi16(_mm_loadu_si128(lanes), keep), 8);
+            _mm_storeu_si128(lanes, _mm_or_si128(_mm_and_si128(lit, full), _mm_andnot_si128(lit, faded)));
+        }
+#else
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            const bool lit = (bits[x >> 6u] >> (63u - (x & 63u))) & 1u;
+            row[x] = lit ? 255 : static_cast<uint16_t>((row[x] * persistence) >> 8u);
+        }
+#endif
+    }
+
+    /**
+     * Mix the four palette colours by the two planes' intensities into RGBA.
+     * Weights: both planes min(i0, i1), plane 0 alone i0 - that, plane 1 alone i1 - that,
+     * background the rest, so they always add up to 255.
+     */
+    void ShadeRow(uint16_t const* i0, uint16_t const* i1, uint32_t* out) const
+    {
+#ifdef CHIP8_VIDEO_SSE2
+        __m128i channel[4][4];
+        for (unsigned int color = 0; color < 4; ++color)
+        {
+            for (unsigned int c = 0; c < 4; ++c)
+            {
+                channel[color][c] = _mm_set1_epi16(static_cast<short>((palette[color] >> (24u - 8u * c)) & 0xFFu));
+            }
+        }
+        const __m128i full = _mm_set1_epi16(255);
+
+        for (unsigned int x = 0; x < width; x += 8)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(i0 + x));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(i1 + x));
+
+            const __m128i both = _mm_min_epi16(a, b);
+            const __m128i weights[4] = {
+                _mm_sub_epi16(full, _mm_max_epi16(a, b)),
+                _mm_sub_epi16(a, both),
+                _mm_sub_epi16(b, both),
+                both
+            };
+
+            // Per channel: sum of weight * colour, at most 255 * 255, then / 255
+            __m128i value[4];
+            for (unsigned int c = 0; c < 4; ++c)
+            {
+                __m128i sum = _mm_setzero_si128();
+                for (unsigned int color = 0; color < 4; ++color)
+                {
+                    sum = _mm_add_epi16(sum, _mm_mullo_epi16(weights[color], channel[color][c]));
+                }
+                // Exact x / 255 for x <= 65025 is (x + 1 + (x >> 8)) >> 8
+                const __m128i rounded = _mm_add_epi16(_mm_add_epi16(sum, _mm_set1_epi16(1)), _mm_srli_epi16(sum, 8));
+                value[c] = _mm_srli_epi16(rounded, 8);
+            }
+
+            // R G B A back into RGBA8888 words
+            const __m128i rg = _mm_or_si128(_mm_slli_epi16(value[0], 8), value[1]);
+            const __m128i ba = _mm_or_si128(_mm_slli_epi16(value[2], 8), value[3]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_unpacklo_epi16(ba, rg));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x + 4), _mm_unpackhi_epi16(ba, rg));
+        }
+#else
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            const unsigned int both = std::min(i0[x], i1[x]);
+            const unsigned int weights[4] = {255u - std::max(i0[x], i1[x]), i0[x] - both, i1[x] - both, both};
+
+            uint32_t pixel = 0;
+            for (unsigned int c = 0; c < 4; ++c)
+            {
+                unsigned int sum = 0;
+                for (unsigned int color = 0; color < 4; ++color)
+                {
+                    sum += weights[color] * ((palette[color] >> (24u - 8u * c)) & 0xFFu);
+                }
+                pixel |= ((sum + 1 + (sum >> 8u)) >> 8u) << (24u - 8u * c);
+            }
+            out[x] = pixel;
+        }
+#endif
+    }
+
+public:
+    /**
+     * @param history frames the OR mode combines, 2 covers the usual erase and redraw
+     * @param persistence share of its glow a pixel keeps each frame in the phosphor mode, 0 to 1
+     */
+    explicit FrameCompositor(CompositeMode mode, unsigned int history = 2, float persistence = 0.5f)
+        : mode(mode),
+          history(std::clamp(history, 1u, COMPOSITE_MAX_HISTORY)),
+          persistence(static_cast<uint16_t>(std::clamp(persistence, 0.0f, 1.0f) * 256.0f))
+    {}
+
+    [[nodiscard]] CompositeMode Mode() const
+    {
+        return mode;
+    }
+
+    /**
+     * Same meaning as Platform::SetPalette, the phosphor mode blends between these.
+     */
+    void SetPalette(uint32_t const* colors, int count)
+    {
+        palette[0] = colors[0];
+        palette[1] = colors[1];
+        palette[2] = count >= 4 ? colors[2] : colors[1];
+        palette[3] = count >= 4 ? colors[3] : colors[1];
+    }
+
+    /**
+     * OR mode: remember this frame and return the union of the last ones,
+     * packed planes laid out as in Chip8::video.
+     */
+    uint64_t const* Combine(uint64_t const* video, unsigned int displayWidth, unsigned int displayHeight)
+    {
+        Resize(displayWidth, displayHeight);
+        memcpy(frames[next], video, sizeof(frames[next]));
+        next = (next + 1) % history;
+
+#ifdef CHIP8_VIDEO_SSE2
+        for (unsigned int i = 0; i < VIDEO_PLANES * VIDEO_PLANE_WORDS; i += 2)
+        {
+            __m128i all = _mm_loadu_si128(reinterpret_cast<__m128i const*>(frames[0] + i));
+            for (unsigned int frame = 1; frame < history; ++frame)
+            {
+                all = _mm_or_si128(all, _mm_loadu_si128(reinterpret_cast<__m128i const*>(frames[frame] + i)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(combined + i), all);
+        }
+#else
+        memcpy(combined, frames[0], sizeof(combined));
+        for (unsigned int frame = 1; frame < history; ++frame)
+        {
+            for (unsigned int i = 0; i < VIDEO_PLANES * VIDEO_PLANE_WORDS; ++i)
+            {
+                combined[i] |= frames[frame][i];
+            }
+        }
+#endif
+
+        return combined;
+    }
+
+    /**
+     * Phosphor mode: fade the glow, relight this frame's pixels and return
+     * displayWidth x displayHeight RGBA8888 pixels, rows packed.
+     */
+    uint32_t const* Blend(uint64_t const* video, unsigned int displayWidth, unsigned int displayHeight)
+    {
+        Resize(displayWidth, displayHeight);
+
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+            {
+                DecayRow(video + plane * VIDEO_PLANE_WORDS + y * VIDEO_ROW_WORDS, intensity[plane] + y * width);
+            }
+            ShadeRow(intensity[0] + y * width, intensity[1] + y * width, pixels + y * width);
+        }
+
+        return pixels;
+    }
+};
+
+#endif //COMPOSITOR_CPP
@@ -0,0 +1,327 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef DISASSEMBLER_CPP
+#define DISASSEMBLER_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Analyzer.cpp"
+#include "Chip8.h"
+#include "Opcodes.h"
+
+// Longest text Format writes, "OP_F000 0xFFFF" and friends are well under it
+constexpr unsigned int DISASSEMBLY_MAX_TEXT = 48;
+// Column the address comment starts at in a listing
+constexpr unsigned int DISASSEMBLY_COMMENT_COLUMN = 36;
+// Bytes per db line for data
+constexpr unsigned int DISASSEMBLY_DATA_WIDTH = 8;
+
+/**
+ * Turns opcodes back into the core's handler names, in the syntax Assembler reads,
+ * so a listing reassembles to the same bytes.
+ * Operand layouts come from the OpName patterns and decoding from DecodeOp, nothing is
+ * tabled twice. Formatting is hand-rolled into a caller buffer, cheap enough to annotate
+ * every line of a long trace.
+ */
+class Disassembler
+{
+    enum class Operand : uint8_t
+    {
+        Register,
+        Nibble,
+        Byte,
+        Address
+    };
+
+    struct Field
+    {
+        Operand kind;
+        uint8_t shift;
+    };
+
+    struct Layout
+    {
+        char name[8]{};
+        uint8_t nameLength{};
+        uint8_t fieldCount{};
+        Field fields[3]{};
+        // The pattern's fixed digits, opcodes that only decode to it through a table alias differ here
+        uint16_t fixedMask{};
+        uint16_t fixedBits{};
+    };
+
+    Layout layouts[static_cast<unsigned int>(Op::TABLE0)]{};
+
+    static char* Hex(char* out, unsigned int value, unsigned int digits)
+    {
+        for (unsigned int i = digits; i-- > 0;)
+        {
+            out[i] = "0123456789ABCDEF"[value & 0xFu];
+            value >>= 4u;
+        }
+        return out + digits;
+    }
+
+    static char* Append(char* out, char const* text, size_t length)
+    {
+        memcpy(out, text, length);
+        return out + length;
+    }
+
+    static char* Address(char* out, unsigned int address, std::string const* label)
+    {
+        if (label && !label->empty())
+        {
+            return Append(out, label->data(), label->size());
+        }
+        return Hex(Append(out, "0x", 2), address, address > 0xFFF ? 4 : 3);
+    }
+
+    /**
+     * Writes the instruction text, labels[a - START_ADDRESS] names address operands when given.
+     * A listing (labels given) writes aliases such as 9xy1 as dw, so they reassemble unchanged.
+     */
+    size_t Write(uint16_t opcode, uint16_t operand, char* out, std::vector<std::string> const* labels) const
+    {
+        const Op op = DecodeOp(opcode);
+        Layout const& format = layouts[static_cast<unsigned int>(op)];
+
+        if (op == Op::OP_NULL || (labels && (opcode & format.fixedMask) != format.fixedBits))
+        {
+            return Hex(Append(out, "dw 0x", 5), opcode, 4) - out;
+        }
+
+        auto label = [&](unsigned int address) -> std::string const* {
+            return labels && address >= START_ADDRESS && address - START_ADDRESS < labels->size()
+                   ? &(*labels)[address - START_ADDRESS] : nullptr;
+        };
+
+        char* end = Append(out, format.name, format.nameLength);
+
+        for (unsigned int i = 0; i < format.fieldCount; ++i)
+        {
+            end = Append(end, i ? ", " : " ", i ? 2 : 1);
+            const unsigned int value = opcode >> format.fields[i].shift;
+
+            switch (format.fields[i].kind)
+            {
+                case Operand::Register:
+                    *end++ = 'V';
+                    end = Hex(end, value, 1);
+                    break;
+                case Operand::Nibble:
+                    if ((value & 0xFu) >= 10)
+                    {
+                        *end++ = '1';
+                    }
+                    *end++ = static_cast<char>('0' + (value & 0xFu) % 10);
+                    break;
+                case Operand::Byte:
+                    end = Hex(Append(end, "0x", 2), value, 2);
+                    break;
+                case Operand::Address:
+                    end = Address(end, value & 0xFFFu, op == Op::OP_Bnnn ? nullptr : label(value & 0xFFFu));
+                    break;
+            }
+        }
+
+        if (op == Op::OP_F000)
+        {
+            end = Address(Append(end, " ", 1), operand, label(operand));
+        }
+
+        return end - out;
+    }
+
+    static bool IsTarget(Op op)
+    {
+        return op == Op::OP_1nnn || op == Op::OP_2nnn;
+    }
+
+public:
+    Disassembler()
+    {
+        for (unsigned int i = 1; i < static_cast<unsigned int>(Op::TABLE0); ++i)
+        {
+            char const* name = OpName(static_cast<Op>(i));
+            Layout& format = layouts[i];
+
+            format.nameLength = static_cast<uint8_t>(std::strlen(name));
+            memcpy(format.name, name, format.nameLength);
+
+            // Same reading of the pattern as Assembler: lower-case runs are operands, in order
+            char const* pattern = name + 3;
+            for (unsigned int digit = 0; digit < 4;)
+            {
+                const char c = pattern[digit];
+                unsigned int run = 1;
+                while (digit + run < 4 && pattern[digit + run] == c)
+                {
+                    ++run;
+                }
+
+                if (c == 'x' || c == 'y')
+                {
+                    format.fields[format.fieldCount++] = Field{Operand::Register, static_cast<uint8_t>(12 - 4 * digit)};
+                }
+                else if (c == 'n' || c == 'k')
+                {
+                    const Operand kind = run == 1 ? Operand::Nibble : run == 2 ? Operand::Byte : Operand::Address;
+                    format.fields[format.fieldCount++] = Field{kind, static_cast<uint8_t>(12 - 4 * (digit + run - 1))};
+                }
+                else
+                {
+                    run = 1;
+                    format.fixedMask |= 0xFu << (12 - 4 * digit);
+                    format.fixedBits |= (c <= '9' ? c - '0' : c - 'A' + 10) << (12 - 4 * digit);
+                }
+                digit += run;
+            }
+        }
+    }
+
+    /**
+     * Text of one instruction into out, which must hold DISASSEMBLY_MAX_TEXT bytes.
+     * operand is the word after the opcode, only F000 uses it.
+     * @return characters written, no terminator
+     */
+    size_t Format(uint16_t opcode, uint16_t operand, char* out) const
+    {
+        return Write(opcode, operand, out, nullptr);
+    }
+
+    [[nodiscard]] std::string Instruction(uint16_t opcode, uint16_t operand = 0) const
+    {
+        char text[DISASSEMBLY_MAX_TEXT];
+        return {text, Format(opcode, operand, text)};
+    }
+
+    /**
+     * Stream a listing of a ROM to sink(std::string_view), one line at a time.
+     * Code is what Analyzer reaches from START_ADDRESS, everything else comes out as db.
+     * Jump and call targets get labels, start_200 / sub_XXX as in the profiler, loc_XXX otherwise,
+     * wherever they land on an instruction or data boundary.
+     */
+    template <typename Sink>
+    void Listing(uint8_t const* rom, size_t size, Sink&& sink) const
+    {
+        size = std::min<size_t>(size, MAX_ROM_SIZE);
+        const RomAnalysis analysis = Analyzer::Analyze(rom, size);
+
+        auto byte = [&](size_t offset) -> uint8_t { return offset < size ? rom[offset] : 0; };
+        auto opcodeAt = [&](size_t offset) -> uint16_t { return (byte(offset) << 8u) | byte(offset + 1); };
+        auto isInstruction = [&](size_t offset) {
+            return (analysis.codeMap[offset] & RomAnalysis::CODE_START) &&
+                   offset + OpLength(DecodeOp(opcodeAt(offset))) <= size;
+        };
+
+        // Where lines start, instructions overlapping an earlier one are left inside it
+        std::vector<uint8_t> lineStart(size, 1);
+        std::vector<uint16_t> targets;
+        for (size_t offset = 0; offset < size;)
+        {
+            if (isInstruction(offset))
+            {
+                const uint16_t opcode = opcodeAt(offset);
+                const size_t length = OpLength(DecodeOp(opcode));
+                if (IsTarget(DecodeOp(opcode)))
+                {
+                    targets.push_back(opcode & 0x0FFFu);
+                }
+                std::fill(lineStart.begin() + offset + 1, lineStart.begin() + offset + length, 0);
+                offset += length;
+            }
+            else
+            {
+                ++offset;
+            }
+        }
+
+        std::vector<std::string> labels(size);
+        char name[16];
+        auto addLabel = [&](unsigned int address, char const* prefix) {
+            const size_t offset = address - START_ADDRESS;
+            if (address >= START_ADDRESS && offset < size && lineStart[offset] && labels[offset].empty())
+            {
+                std::snprintf(name, sizeof(name), "%s_%03X", prefix, address);
+                labels[offset] = name;
+            }
+        };
+
+        addLabel(START_ADDRESS, "start");
+        for (Function const& function : analysis.functions)
+        {
+            addLabel(function.entry, "sub");
+        }
+        for (const uint16_t target : targets)
+        {
+            addLabel(target, "loc");
+        }
+
+        char line[DISASSEMBLY_COMMENT_COLUMN + DISASSEMBLY_MAX_TEXT + 32];
+        auto comment = [&](char* end, size_t offset, size_t length) {
+            do
+            {
+                *end++ = ' ';
+            }
+            while (end < line + DISASSEMBLY_COMMENT_COLUMN);
+            end = Hex(Append(end, "; ", 2), START_ADDRESS + offset, 3);
+            *end++ = ' ';
+            for (size_t i = 0; i < length; ++i)
+            {
+                end = Hex(end, byte(offset + i), 2);
+            }
+            *end++ = '\n';
+            sink(std::string_view(line, end - line));
+        };
+
+        for (size_t offset = 0; offset < size;)
+        {
+            if (!labels[offset].empty())
+            {
+                char* end = Append(line, labels[offset].data(), labels[offset].size());
+                end = Append(end, ":\n", 2);
+                sink(std::string_view(line, end - line));
+            }
+
+            char* end = Append(line, "        ", 8);
+            if (isInstruction(offset))
+            {
+                const uint16_t opcode = opcodeAt(offset);
+                const size_t length = OpLength(DecodeOp(opcode));
+                end += Write(opcode, opcodeAt(offset + 2), end, &labels);
+                comment(end, offset, length);
+                offset += length;
+                continue;
+            }
+
+            // A run of data, cut at code, labels and the line width
+            size_t length = 0;
+            end = Append(end, "db", 2);
+            do
+            {
+                end = Hex(Append(end, length ? ", 0x" : " 0x", length ? 4 : 3), byte(offset + length), 2);
+                ++length;
+            }
+            while (length < DISASSEMBLY_DATA_WIDTH && offset + length < size &&
+                   labels[offset + length].empty() && !isInstruction(offset + length));
+
+            comment(end, offset, length);
+            offset += length;
+        }
+    }
+
+    void Listing(uint8_t const* rom, size_t size, FILE* out) const
+    {
+        Listing(rom, size, [out](std::string_view line) { std::fwrite(line.data(), 1, line.size(), out); });
+    }
+};
+
+#endif //DISASSEMBLER_CPP
@@ -0,0 +1,173 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ENGINE_CPP
+#define ENGINE_CPP
+
+#include <cstdint>
+#include "Chip8.cpp"
+#include "Opcodes.h"
+
+#ifdef CHIP8_RECOMPILED
+#include "Recompiled.h"
+#endif
+
+/**
+ * Something that executes guest instructions on a Chip8.
+ * Every engine must leave the machine in exactly the state the interpreter would,
+ * instruction for instruction, which is what the lockstep validator checks.
+ */
+class ExecutionEngine
+{
+public:
+    virtual ~ExecutionEngine() = default;
+
+    [[nodiscard]] virtual char const* Name() const = 0;
+
+    /**
+     * Execute exactly this many instructions, timers ticking once per instruction.
+     */
+    virtual void Run(Chip8& chip8, unsigned int instructions) = 0;
+
+    /**
+     * A front end's frame: the instruction budget, then the vblank that releases a Dxyn
+     * held by the display-wait quirk. Run alone never raises it.
+     */
+    void RunFrame(Chip8& chip8, unsigned int instructions)
+    {
+        Run(chip8, instructions);
+        chip8.Vblank();
+    }
+};
+
+/**
+ * The reference: Chip8::Cycle and its member function pointer tables.
+ */
+class InterpreterEngine : public ExecutionEngine
+{
+public:
+    [[nodiscard]] char const* Name() const override { return "interpreter"; }
+
+    void Run(Chip8& chip8, unsigned int instructions) override
+    {
+        // Not RunFrame, an instruction budget is not a frame and must not raise the vblank
+        for (unsigned int i = 0; i < instructions; ++i)
+        {
+            chip8.Cycle();
+        }
+    }
+};
+
+/**
+ * Decodes through the shared tables and dispatches with one switch,
+ * so every handler is a direct call the compiler can inline instead of two indirect ones.
+ */
+class SwitchEngine : public ExecutionEngine
+{
+    static void Step(Chip8& chip8)
+    {
+        chip8.opcode = (chip8.memory[chip8.pc & MEMORY_MASK] << 8u) | chip8.memory[(chip8.pc + 1) & MEMORY_MASK];
+        chip8.pc += 2;
+
+        switch (DecodeOp(chip8.opcode))
+        {
+            case Op::OP_00Cn: chip8.OP_00Cn(); break;
+            case Op::OP_00Dn: chip8.OP_00Dn(); break;
+            case Op::OP_00E0: chip8.OP_00E0(); break;
+            case Op::OP_00EE: chip8.OP_00EE(); break;
+            case Op::OP_00FB: chip8.OP_00FB(); break;
+            case Op::OP_00FC: chip8.OP_00FC(); break;
+            case Op::OP_00FD: chip8.OP_00FD(); break;
+            case Op::OP_00FE: chip8.OP_00FE(); break;
+            case Op::OP_00FF: chip8.OP_00FF(); break;
+            case Op::OP_1nnn: chip8.OP_1nnn(); break;
+            case Op::OP_2nnn: chip8.OP_2nnn(); break;
+            case Op::OP_3xkk: chip8.OP_3xkk(); break;
+            case Op::OP_4xkk: chip8.OP_4xkk(); break;
+            case Op::OP_5xy0: chip8.OP_5xy0(); break;
+            case Op::OP_5xy2: chip8.OP_5xy2(); break;
+            case Op::OP_5xy3: chip8.OP_5xy3(); break;
+            case Op::OP_6xkk: chip8.OP_6xkk(); break;
+            case Op::OP_7xkk: chip8.OP_7xkk(); break;
+            case Op::OP_8xy0: chip8.OP_8xy0(); break;
+            case Op::OP_8xy1: chip8.OP_8xy1(); break;
+            case Op::OP_8xy2: chip8.OP_8xy2(); break;
+            case Op::OP_8xy3: chip8.OP_8xy3(); break;
+            case Op::OP_8xy4: chip8.OP_8xy4(); break;
+            case Op::OP_8xy5: chip8.OP_8xy5(); break;
+            case Op::OP_8xy6: chip8.OP_8xy6(); break;
+            case Op::OP_8xy7: chip8.OP_8xy7(); break;
+            case Op::OP_8xyE: chip8.OP_8xyE(); break;
+            case Op::OP_9xy0: chip8.OP_9xy0(); break;
+            case Op::OP_Annn: chip8.OP_Annn(); break;
+            case Op::OP_Bnnn: chip8.OP_Bnnn(); break;
+            case Op::OP_Cxkk: chip8.OP_Cxkk(); break;
+            case Op::OP_Dxyn: chip8.OP_Dxyn(); break;
+            case Op::OP_Ex9E: chip8.OP_Ex9E(); break;
+            case Op::OP_ExA1: chip8.OP_ExA1(); break;
+            case Op::OP_F000: chip8.OP_F000(); break;
+            case Op::OP_Fn01: chip8.OP_Fn01(); break;
+            case Op::OP_F002: chip8.OP_F002(); break;
+            case Op::OP_Fx07: chip8.OP_Fx07(); break;
+            case Op::OP_Fx0A: chip8.OP_Fx0A(); break;
+            case Op::OP_Fx15: chip8.OP_Fx15(); break;
+            case Op::OP_Fx18: chip8.OP_Fx18(); break;
+            case Op::OP_Fx1E: chip8.OP_Fx1E(); break;
+            case Op::OP_Fx29: chip8.OP_Fx29(); break;
+            case Op::OP_Fx30: chip8.OP_Fx30(); break;
+            case Op::OP_Fx33: chip8.OP_Fx33(); break;
+            case Op::OP_Fx3A: chip8.OP_Fx3A(); break;
+            case Op::OP_Fx55: chip8.OP_Fx55(); break;
+            case Op::OP_Fx65: chip8.OP_Fx65(); break;
+            case Op::OP_Fx75: chip8.OP_Fx75(); break;
+            case Op::OP_Fx85: chip8.OP_Fx85(); break;
+            default: chip8.OP_NULL(); break;
+        }
+
+        chip8.TickTimers();
+    }
+
+public:
+    [[nodiscard]] char const* Name() const override { return "switch"; }
+
+    void Run(Chip8& chip8, unsigned int instructions) override
+    {
+        for (unsigned int i = 0; i < instructions; ++i)
+        {
+            Step(chip8);
+        }
+    }
+};
+
+#ifdef CHIP8_RECOMPILED
+/**
+ * The ahead-of-time compiled blocks linked into this executable.
+ * A block that would run past the budget is interpreted instead, so counts stay exact.
+ */
+class RecompiledEngine : public ExecutionEngine
+{
+public:
+    [[nodiscard]] char const* Name() const override { return "recompiled"; }
+
+    void Run(Chip8& chip8, unsigned int instructions) override
+    {
+        for (unsigned int executed = 0; executed < instructions;)
+        {
+            const unsigned int length = RecompiledBlockLength(chip8.pc);
+
+            if (length == 0 || length > instructions - executed)
+            {
+                chip8.Cycle();
+                ++executed;
+            }
+            else
+            {
+                executed += RunRecompiledBlock(chip8);
+            }
+        }
+    }
+};
+#endif
+
+#endif //ENGINE_CPP
@@ -0,0 +1,300 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ENVIRONMENT_CPP
+#define ENVIRONMENT_CPP
+
+#include <algorithm>
+#include <barrier>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Chip8.cpp"
+
+enum class Observation
+{
+    Packed,     // the display words as stored, VIDEO_PLANES * 64 rows * 16 bytes
+    Downsampled // one byte per 64x32 pixel holding its plane bits, hires 2x2 blocks ORed together
+};
+
+/**
+ * Score for the step that just ran, read from memory or registers.
+ * scratch belongs to the instance, zeroed on reset, e.g. to hold the last score for a delta.
+ */
+typedef float (*RewardHook)(Chip8State const& state, uint32_t& scratch);
+
+/**
+ * End of episode test, checked after every frame.
+ */
+typedef bool (*DoneHook)(Chip8State const& state);
+
+struct EnvConfig
+{
+    unsigned int cyclesPerFrame = 10;
+    // Anything but Instructions ignores cyclesPerFrame and runs VIP-timed frames
+    TimingMode timing = TimingMode::Instructions;
+    // Display-wait quirk, one sprite per frame as on the VIP
+    bool displayWait = false;
+    unsigned int frameSkip = 4; // frames run per step with the same keys held
+    Observation observation = Observation::Downsampled;
+    RewardHook reward = nullptr;
+    DoneHook done = nullptr; // the ROM exiting always ends the episode
+    unsigned int threads = 1;
+};
+
+/**
+ * A batch of Chip8 instances stepped together, gym style.
+ * Resets copy a boot snapshot taken once after loading the ROM,
+ * observations, rewards and done flags go straight into caller buffers,
+ * and finished instances reset themselves on the next step.
+ */
+class Chip8Env
+{
+    EnvConfig config;
+    Chip8State boot{};
+    std::vector<Chip8> instances;
+    std::vector<uint32_t> scratch;
+    std::vector<uint64_t> episodes;
+    std::vector<uint8_t> finished;
+    uint64_t seed{};
+
+    // Per step arguments for the workers
+    uint16_t const* stepActions{};
+    uint8_t* stepObservations{};
+    float* stepRewards{};
+    uint8_t* stepDones{};
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<std::barrier<>> start;
+    std::unique_ptr<std::barrier<>> finish;
+    bool stopping{};
+
+    void ResetInstance(size_t i)
+    {
+        Chip8& chip8 = instances[i];
+        chip8.LoadState(boot);
+        chip8.randGen.seed(seed + i + episodes[i] * instances.size());
+        ++episodes[i];
+
+        scratch[i] = 0;
+        finished[i] = false;
+        if (config.reward)
+        {
+            // Lets delta rewards pick up the starting score
+            config.reward(chip8, scratch[i]);
+        }
+    }
+
+    void WriteObservation(size_t i, uint8_t* out) const
+    {
+        Chip8 const& chip8 = instances[i];
+
+        if (config.observation == Observation::Packed)
+        {
+            memcpy(out, chip8.video, sizeof(chip8.video));
+            return;
+        }
+
+        const unsigned int shift = chip8.hires ? 1 : 0;
+        for (unsigned int y = 0; y < VIDEO_HEIGHT; ++y)
+        {
+            for (unsigned int x = 0; x < VIDEO_WIDTH; ++x)
+            {
+                uint8_t value = 0;
+                for (unsigned int dy = 0; dy <= shift; ++dy)
+                {
+                    for (unsigned int dx = 0; dx <= shift; ++dx)
+                    {
+                        const unsigned int row = (y << shift) + dy;
+                        const unsigned int column = (x << shift) + dx;
+                        const unsigned int bit = 63u - (column & 63u);
+                        value |= (chip8.video[0][row][column >> 6u] >> bit) & 1u;
+                        value |= ((chip8.video[1][row][column >> 6u] >> bit) & 1u) << 1u;
+                    }
+                }
+                out[y * VIDEO_WIDTH + x] = value;
+            }
+        }
+    }
+
+    void StepRange(size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            if (finished[i])
+            {
+                ResetInstance(i);
+            }
+
+            Chip8& chip8 = instances[i];
+            const uint16_t keys = stepActions[i];
+            for (unsigned int key = 0; key < 16; ++key)
+            {
+                chip8.keypad[key] = (keys >> key) & 1u;
+            }
+
+            float reward = 0.0f;
+            bool done = false;
+            for (unsigned int frame = 0; frame < config.frameSkip && !done; ++frame)
+            {
+                if (config.timing == TimingMode::Instructions)
+                {
+                    chip8.RunFrame(config.cyclesPerFrame);
+                }
+                else
+                {
+                    chip8.RunTimedFrame(config.timing);
+                }
+
+                if (config.reward)
+                {
+                    reward += config.reward(chip8, scratch[i]);
+                }
+                done = chip8.exited || (config.done && config.done(chip8));
+            }
+
+            finished[i] = done;
+            if (stepRewards)
+            {
+                stepRewards[i] = reward;
+            }
+            if (stepDones)
+            {
+                stepDones[i] = done;
+            }
+            if (stepObservations)
+            {
+                WriteObservation(i, stepObservations + i * ObservationSize());
+            }
+        }
+    }
+
+    [[nodiscard]] size_t SliceBegin(size_t worker) const
+    {
+        return instances.size() * worker / (workers.size() + 1);
+    }
+
+    void WorkerLoop(size_t worker)
+    {
+        while (true)
+        {
+            start->arrive_and_wait();
+            if (stopping)
+            {
+                return;
+            }
+
+            StepRange(SliceBegin(worker), SliceBegin(worker + 1));
+            finish->arrive_and_wait();
+        }
+    }
+
+public:
+    /**
+     * @param rom ROM image every instance boots from
+     * @param count number of instances in the batch, at least 1
+     */
+    Chip8Env(uint8_t const* rom, size_t size, size_t count, EnvConfig const& config)
+        : config(config), instances(count), scratch(count), episodes(count), finished(count)
+    {
+        // Booted apart from the instances, an empty batch has none to borrow
+        Chip8 machine;
+        machine.LoadROM(rom, size);
+        machine.displayWait = config.displayWait;
+        machine.SaveState(boot);
+
+        // The calling thread takes the last slice
+        const size_t threads = std::max<size_t>(1, std::min<size_t>(config.threads, count));
+        start = std::make_unique<std::barrier<>>(threads);
+        finish = std::make_unique<std::barrier<>>(threads);
+        for (size_t worker = 0; worker + 1 < threads; ++worker)
+        {
+            workers.emplace_back(&Chip8Env::WorkerLoop, this, worker);
+        }
+
+        // Every instance starts on the ROM, Step before any Reset included
+        Reset(0, nullptr);
+    }
+
+    ~Chip8Env()
+    {
+        stopping = true;
+        if (!workers.empty())
+        {
+            start->arrive_and_wait();
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    Chip8Env(Chip8Env const&) = delete;
+    Chip8Env& operator=(Chip8Env const&) = delete;
+
+    [[nodiscard]] size_t Count() const { return instances.size(); }
+
+    /**
+     * Bytes each instance writes into the observation buffer.
+     */
+    [[nodiscard]] size_t ObservationSize() const
+    {
+        return config.observation == Observation::Packed
+                   ? sizeof(Chip8State::video)
+                   : VIDEO_WIDTH * VIDEO_HEIGHT;
+    }
+
+    /**
+     * Restart every instance. Instance i is seeded with seed + i,
+     * so a batch replays exactly given the same seed and actions.
+     * @param observations Count() * ObservationSize() bytes, or null
+     */
+    void Reset(uint64_t newSeed, uint8_t* observations)
+    {
+        seed = newSeed;
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            episodes[i] = 0;
+            ResetInstance(i);
+            if (observations)
+            {
+                WriteObservation(i, observations + i * ObservationSize());
+            }
+        }
+    }
+
+    /**
+     * Advance every instance by frameSkip frames.
+     * @param actions keypad bitmask per instance, bit n holds key n
+     * @param observations Count() * ObservationSize() bytes, or null to skip them
+     * @param rewards Count() floats, or null
+     * @param dones Count() flags, set when the instance resets on the next step
+     */
+    void Step(uint16_t const* actions, uint8_t* observations, float* rewards, uint8_t* dones)
+    {
+        stepActions = actions;
+        stepObservations = observations;
+        stepRewards = rewards;
+        stepDones = dones;
+
+        if (workers.empty())
+        {
+            StepRange(0, instances.size());
+            return;
+        }
+
+        start->arrive_and_wait();
+        StepRange(SliceBegin(workers.size()), instances.size());
+        finish->arrive_and_wait();
+    }
+
+    /**
+     * Direct access for reward code and debugging.
+     */
+    [[nodiscard]] Chip8 const& Instance(size_t i) const { return instances[i]; }
+};
+
+#endif //ENVIRONMENT_CPP
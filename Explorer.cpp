@@ -0,0 +1,514 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef EXPLORER_CPP
+#define EXPLORER_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+#include "Chip8.cpp"
+#include "Opcodes.h"
+
+constexpr unsigned int MEMORY_LINES = MEMORY_SIZE / MEMORY_LINE_SIZE;
+constexpr unsigned int STATE_SET_SHARDS = 64;
+
+/**
+ * 128-bit identity of a machine state, two independent hashes over the same bytes.
+ */
+struct StateKey
+{
+    uint64_t low{};
+    uint64_t high{};
+
+    bool operator==(StateKey const& other) const = default;
+};
+
+struct StateKeyHash
+{
+    size_t operator()(StateKey const& key) const { return key.low; }
+};
+
+/**
+ * A machine state stored as its difference from the boot state.
+ * Memory is kept as the 64-byte lines that changed, usually a handful,
+ * so a snapshot is the CPU, the display and a few lines instead of all 64 KB.
+ */
+struct CompactState
+{
+    CpuState cpu;
+    uint64_t video[VIDEO_PLANES][HIRES_VIDEO_HEIGHT][VIDEO_ROW_WORDS]{};
+    std::vector<uint16_t> lines;
+    std::vector<uint8_t> lineData;
+};
+
+enum class CrashKind
+{
+    InvalidOpcode,
+    StackOverflow,
+    StackUnderflow
+};
+
+inline char const* CrashName(CrashKind kind)
+{
+    switch (kind)
+    {
+        case CrashKind::InvalidOpcode: return "invalid opcode";
+        case CrashKind::StackOverflow: return "stack overflow";
+        case CrashKind::StackUnderflow: return "stack underflow";
+    }
+    return "";
+}
+
+struct CrashState
+{
+    CrashKind kind{};
+    uint16_t pc{};
+    uint16_t opcode{};
+    // Keypad bitmask held for each input step, from boot to the crash
+    std::vector<uint16_t> inputs;
+};
+
+struct ExplorerConfig
+{
+    unsigned int cyclesPerFrame = 10;
+    unsigned int framesPerInput = 1;
+    unsigned int maxDepth = 60;
+    size_t maxStates = 1000000;
+    // Keypad bitmasks tried from every state, empty means no key plus each key alone
+    std::vector<uint16_t> actions;
+    unsigned int threads = 0; // 0 uses every core
+    // Random number seed of the boot state, the same seed explores the same graph and replays its crashes
+    uint64_t seed = 1;
+};
+
+struct ExplorationResult
+{
+    // New states found at each input depth, [0] is the boot state
+    std::vector<size_t> statesPerDepth;
+    size_t states{};
+    size_t exits{};
+    // One per crash kind and pc, reached with the fewest inputs
+    std::vector<CrashState> crashes;
+    // Ran into maxStates before maxDepth
+    bool truncated{};
+};
+
+/**
+ * Set of seen states, split into independently locked shards so all threads can insert at once.
+ */
+class ConcurrentStateSet
+{
+    struct Shard
+    {
+        std::mutex lock;
+        std::unordered_set<StateKey, StateKeyHash> keys;
+    };
+
+    Shard shards[STATE_SET_SHARDS];
+    std::atomic<size_t> size{};
+
+public:
+    /**
+     * @return true if the key was not in the set yet
+     */
+    bool Insert(StateKey const& key)
+    {
+        Shard& shard = shards[key.high % STATE_SET_SHARDS];
+        std::lock_guard guard(shard.lock);
+
+        if (!shard.keys.insert(key).second)
+        {
+            return false;
+        }
+
+        size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] size_t Size() const
+    {
+        return size.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Breadth-first search over keypad inputs, one input per frame (or framesPerInput frames).
+ * Every resulting state is hashed and kept only if it was never seen before,
+ * so the frontier stays the set of genuinely new states. Runs on all cores.
+ */
+class StateExplorer
+{
+    struct Node
+    {
+        uint32_t parent{};
+        uint16_t input{};
+    };
+
+    struct Child
+    {
+        uint32_t parent{};
+        uint16_t input{};
+        CompactState state;
+    };
+
+    /**
+     * One thread's machine, kept in sync with the boot state line by line.
+     */
+    struct Worker
+    {
+        Chip8 chip8;
+        // Lines that currently differ (or may differ) from boot
+        std::vector<uint16_t> lines;
+        std::vector<uint8_t> marked = std::vector<uint8_t>(MEMORY_LINES);
+        std::vector<Child> children;
+        std::vector<CrashState> crashes;
+        size_t exits{};
+    };
+
+    ExplorerConfig config;
+    Chip8State boot{};
+    ConcurrentStateSet seen;
+
+    // Parent links and inputs for every kept state, by depth
+    std::vector<std::vector<Node>> levels;
+
+    static uint64_t HashBytes(void const* data, size_t size, uint64_t hash)
+    {
+        auto const* bytes = static_cast<uint8_t const*>(data);
+
+        for (; size >= 8; bytes += 8, size -= 8)
+        {
+            uint64_t word;
+            memcpy(&word, bytes, 8);
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 32u;
+        }
+        for (; size > 0; ++bytes, --size)
+        {
+            hash = (hash ^ *bytes) * 0x100000001B3ull;
+        }
+
+        return hash;
+    }
+
+    static StateKey Key(CompactState const& state)
+    {
+        StateKey key{0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full};
+
+        for (uint64_t* part : {&key.low, &key.high})
+        {
+            uint64_t hash = *part;
+            hash = HashBytes(&state.cpu, sizeof(state.cpu), hash);
+            hash = HashBytes(state.video, sizeof(state.video), hash);
+            hash = HashBytes(state.lines.data(), state.lines.size() * sizeof(uint16_t), hash);
+            hash = HashBytes(state.lineData.data(), state.lineData.size(), hash);
+            *part = hash;
+        }
+
+        return key;
+    }
+
+    /**
+     * A memory line, lines never straddle pages.
+     */
+    static uint8_t const* Line(PagedMemory<MEMORY_SIZE> const& memory, unsigned int offset)
+    {
+        return memory.Page(offset >> PAGE_SHIFT) + (offset & PAGE_OFFSET_MASK);
+    }
+
+    void Save(Worker& worker, CompactState& state) const
+    {
+        Chip8 const& chip8 = worker.chip8;
+
+        chip8.SaveCpu(state.cpu);
+        memcpy(state.video, chip8.video, sizeof(state.video));
+
+        // Only lines something wrote to can differ, and sorted lines keep the key canonical
+        chip8.memory.ForEachDirtyLine([&](unsigned int line) { Mark(worker, line); });
+        std::sort(worker.lines.begin(), worker.lines.end());
+        state.lines.clear();
+        state.lineData.clear();
+        for (const uint16_t line : worker.lines)
+        {
+            const unsigned int offset = line * MEMORY_LINE_SIZE;
+            uint8_t const* bytes = Line(chip8.memory, offset);
+            if (!chip8.memory.SharesPage(boot.memory, offset >> PAGE_SHIFT)
+                && memcmp(bytes, Line(boot.memory, offset), MEMORY_LINE_SIZE) != 0)
+            {
+                state.lines.push_back(line);
+                state.lineData.insert(state.lineData.end(), bytes, bytes + MEMORY_LINE_SIZE);
+            }
+        }
+    }
+
+    void Load(Worker& worker, CompactState const& state) const
+    {
+        Chip8& chip8 = worker.chip8;
+
+        for (const uint16_t line : worker.lines)
+        {
+            const unsigned int offset = line * MEMORY_LINE_SIZE;
+            if (!chip8.memory.SharesPage(boot.memory, offset >> PAGE_SHIFT))
+            {
+                chip8.memory.Write(offset, Line(boot.memory, offset), MEMORY_LINE_SIZE);
+            }
+            worker.marked[line] = 0;
+        }
+        worker.lines.clear();
+
+        for (size_t i = 0; i < state.lines.size(); ++i)
+        {
+            const unsigned int offset = state.lines[i] * MEMORY_LINE_SIZE;
+            chip8.memory.Write(offset, &state.lineData[i * MEMORY_LINE_SIZE], MEMORY_LINE_SIZE);
+            Mark(worker, state.lines[i]);
+        }
+
+        chip8.LoadCpu(state.cpu);
+        memcpy(chip8.video, state.video, sizeof(state.video));
+        memset(chip8.rowHash, 0, sizeof(chip8.rowHash));
+        chip8.frameHash = 0;
+        chip8.RehashRows(0, HIRES_VIDEO_HEIGHT);
+
+        // From here the dirty lines are exactly what the next input writes
+        chip8.Checkpoint();
+    }
+
+    static void Mark(Worker& worker, unsigned int line)
+    {
+        if (!worker.marked[line])
+        {
+            worker.marked[line] = 1;
+            worker.lines.push_back(line);
+        }
+    }
+
+    /**
+     * Run one input step cycle by cycle, stopping at the first crash.
+     * @return true if the machine crashed, with the crash filled in
+     */
+    bool RunInput(Worker& worker, CrashState& crash) const
+    {
+        Chip8& chip8 = worker.chip8;
+        const unsigned int cycles = config.cyclesPerFrame * config.framesPerInput;
+
+        for (unsigned int i = 0; i < cycles && !chip8.exited; ++i)
+        {
+            const uint16_t pc = chip8.pc;
+            const uint16_t opcode = (chip8.memory[pc & MEMORY_MASK] << 8u) | chip8.memory[(pc + 1) & MEMORY_MASK];
+            const Op op = DecodeOp(opcode);
+
+            if (op == Op::OP_NULL)
+            {
+                crash.kind = CrashKind::InvalidOpcode;
+                crash.pc = pc;
+                crash.opcode = opcode;
+                return true;
+            }
+
+            chip8.Cycle();
+
+            // sp runs past the stack rather than wrapping, so both directions show up here
+            if (chip8.sp > STACK_SIZE)
+            {
+                crash.kind = chip8.sp & 0x80u ? CrashKind::StackUnderflow : CrashKind::StackOverflow;
+                crash.pc = pc;
+                crash.opcode = opcode;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Expand(Worker& worker, std::vector<CompactState> const& frontier, uint32_t first, uint32_t last)
+    {
+        for (uint32_t parent = first; parent < last; ++parent)
+        {
+            for (const uint16_t input : config.actions)
+            {
+                Load(worker, frontier[parent]);
+                for (unsigned int key = 0; key < 16; ++key)
+                {
+                    worker.chip8.keypad[key] = (input >> key) & 1u;
+                }
+
+                CrashState crash;
+                if (RunInput(worker, crash))
+                {
+                    crash.inputs = Path(parent);
+                    crash.inputs.push_back(input);
+                    worker.crashes.push_back(std::move(crash));
+                    continue;
+                }
+
+                Child child{parent, input, {}};
+                Save(worker, child.state);
+
+                if (worker.chip8.exited)
+                {
+                    ++worker.exits;
+                    continue;
+                }
+                if (seen.Size() >= config.maxStates || !seen.Insert(Key(child.state)))
+                {
+                    continue;
+                }
+
+                worker.children.push_back(std::move(child));
+            }
+        }
+    }
+
+    /**
+     * Inputs leading from boot to a state of the newest level.
+     */
+    [[nodiscard]] std::vector<uint16_t> Path(uint32_t node) const
+    {
+        std::vector<uint16_t> inputs;
+
+        for (size_t depth = levels.size() - 1; depth > 0; --depth)
+        {
+            Node const& step = levels[depth][node];
+            inputs.push_back(step.input);
+            node = step.parent;
+        }
+
+        std::reverse(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    StateExplorer(uint8_t const* rom, size_t size, ExplorerConfig const& config)
+        : config(config)
+    {
+        Chip8 chip8;
+        chip8.LoadROM(rom, size);
+        chip8.randGen.seed(config.seed);
+        chip8.SaveState(boot);
+
+        if (this->config.actions.empty())
+        {
+            this->config.actions.push_back(0);
+            for (unsigned int key = 0; key < 16; ++key)
+            {
+                this->config.actions.push_back(1u << key);
+            }
+        }
+        if (this->config.threads == 0)
+        {
+            this->config.threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    ExplorationResult Run()
+    {
+        ExplorationResult result;
+
+        std::vector<Worker> workers(config.threads);
+        for (Worker& worker : workers)
+        {
+            worker.chip8.LoadState(boot);
+        }
+
+        std::vector<CompactState> frontier(1);
+        Save(workers[0], frontier[0]);
+        seen.Insert(Key(frontier[0]));
+        levels.push_back({Node{}});
+        result.statesPerDepth.push_back(1);
+
+        for (unsigned int depth = 1; depth <= config.maxDepth && !frontier.empty(); ++depth)
+        {
+            // Hand out parents in small batches so uneven frames still balance
+            std::atomic<uint32_t> next{0};
+            const auto total = static_cast<uint32_t>(frontier.size());
+            const uint32_t batch = std::max(1u, std::min(64u, total / (config.threads * 8)));
+
+            auto work = [&](Worker& worker) {
+                for (uint32_t first; (first = next.fetch_add(batch)) < total;)
+                {
+                    Expand(worker, frontier, first, std::min(total, first + batch));
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < workers.size(); ++i)
+            {
+                threads.emplace_back(work, std::ref(workers[i]));
+            }
+            work(workers[0]);
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            std::vector<Node> level;
+            std::vector<CompactState> nextFrontier;
+            for (Worker& worker : workers)
+            {
+                for (Child& child : worker.children)
+                {
+                    level.push_back({child.parent, child.input});
+                    nextFrontier.push_back(std::move(child.state));
+                }
+                worker.children.clear();
+
+                result.crashes.insert(result.crashes.end(),
+                                      std::make_move_iterator(worker.crashes.begin()),
+                                      std::make_move_iterator(worker.crashes.end()));
+                worker.crashes.clear();
+                result.exits += worker.exits;
+                worker.exits = 0;
+            }
+
+            levels.push_back(std::move(level));
+            frontier = std::move(nextFrontier);
+            result.statesPerDepth.push_back(frontier.size());
+
+            if (seen.Size() >= config.maxStates)
+            {
+                result.truncated = depth < config.maxDepth;
+                break;
+            }
+        }
+
+        // Keep the shortest path to each distinct crash
+        std::stable_sort(result.crashes.begin(), result.crashes.end(), [](CrashState const& a, CrashState const& b) {
+            return a.inputs.size() != b.inputs.size()
+                       ? a.inputs.size() < b.inputs.size()
+                       : std::tie(a.kind, a.pc) < std::tie(b.kind, b.pc);
+        });
+        std::vector<CrashState> unique;
+        for (CrashState& crash : result.crashes)
+        {
+            const bool known = std::any_of(unique.begin(), unique.end(), [&](CrashState const& other) {
+                return other.kind == crash.kind && other.pc == crash.pc;
+            });
+            if (!known)
+            {
+                unique.push_back(std::move(crash));
+            }
+        }
+        result.crashes = std::move(unique);
+        result.states = seen.Size();
+
+        return result;
+    }
+
+public:
+    /**
+     * Explore the states reachable from booting a ROM.
+     */
+    static ExplorationResult Explore(uint8_t const* rom, size_t size, ExplorerConfig const& config)
+    {
+        return StateExplorer(rom, size, config).Run();
+    }
+};
+
+#endif //EXPLORER_CPP
@@ -0,0 +1,126 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef MAPPEDFILE_CPP
+#define MAPPEDFILE_CPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Read-only view of a whole file mapped into memory.
+ * The OS pages the file in on first touch, there is no intermediate buffer.
+ */
+class MappedFile
+{
+    uint8_t const* bytes{};
+    size_t length{};
+    bool open{};
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping{};
+#endif
+
+public:
+    explicit MappedFile(char const* filename)
+    {
+#ifdef _WIN32
+        file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        open = true;
+
+        // Zero length files can't be mapped, they are just empty
+        if (length == 0)
+        {
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            bytes = static_cast<uint8_t const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        const int fd = ::open(filename, O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) == 0)
+        {
+            length = static_cast<size_t>(info.st_size);
+            open = true;
+
+            // Zero length files can't be mapped, they are just empty
+            if (length > 0)
+            {
+                void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                bytes = view == MAP_FAILED ? nullptr : static_cast<uint8_t const*>(view);
+            }
+        }
+
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+#endif
+
+        if (length > 0 && !bytes)
+        {
+            open = false;
+            length = 0;
+        }
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (bytes)
+        {
+            UnmapViewOfFile(bytes);
+        }
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+#else
+        if (bytes)
+        {
+            munmap(const_cast<uint8_t*>(bytes), length);
+        }
+#endif
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    [[nodiscard]] bool IsOpen() const { return open; }
+    [[nodiscard]] uint8_t const* Data() const { return bytes; }
+    [[nodiscard]] size_t Size() const { return length; }
+};
+
+#endif //MAPPEDFILE_CPP
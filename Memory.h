@@ -0,0 +1,232 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+constexpr unsigned int PAGE_SIZE = 256;
+constexpr unsigned int PAGE_SHIFT = 8;
+constexpr unsigned int PAGE_OFFSET_MASK = PAGE_SIZE - 1;
+// Granularity of dirty tracking, a page holds several lines
+constexpr unsigned int MEMORY_LINE_SIZE = 64;
+constexpr unsigned int MEMORY_LINE_SHIFT = 6;
+
+struct MemoryPage
+{
+    std::atomic<uint32_t> refs{1};
+    // Owned by a process-wide image, never counted or freed
+    bool pinned{};
+    uint8_t bytes[PAGE_SIZE]{};
+};
+
+/**
+ * Byte-addressed memory made of copy-on-write pages.
+ * Copying shares every page, a page is cloned only when a copy writes to it.
+ * Untouched memory all points at one zero page, and machines copied from the same
+ * booted state share its font and ROM pages, so a snapshot costs the page table
+ * plus whatever was written since.
+ * Every write also marks its 64-byte line dirty until ClearDirty, for incremental snapshots.
+ * Addresses are expected to be masked by the caller.
+ */
+template <unsigned int Size>
+class PagedMemory
+{
+    static constexpr unsigned int PAGE_COUNT = Size / PAGE_SIZE;
+    static constexpr unsigned int LINE_COUNT = Size / MEMORY_LINE_SIZE;
+
+    MemoryPage* pages[PAGE_COUNT];
+    uint64_t dirty[LINE_COUNT / 64]{};
+
+    void MarkDirty(unsigned int first, unsigned int last)
+    {
+        for (unsigned int line = first; line <= last; ++line)
+        {
+            dirty[line / 64] |= 1ull << (line % 64);
+        }
+    }
+
+    static MemoryPage* ZeroPage()
+    {
+        static MemoryPage zero{1, true};
+        return &zero;
+    }
+
+    static void Acquire(MemoryPage* page)
+    {
+        if (!page->pinned)
+        {
+            page->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void Release(MemoryPage* page)
+    {
+        if (!page->pinned && page->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete page;
+        }
+    }
+
+    void ReleaseAll()
+    {
+        for (MemoryPage* page : pages)
+        {
+            Release(page);
+        }
+    }
+
+public:
+    PagedMemory()
+    {
+        std::fill(std::begin(pages), std::end(pages), ZeroPage());
+    }
+
+    PagedMemory(PagedMemory const& other)
+    {
+        memcpy(dirty, other.dirty, sizeof(dirty));
+        for (unsigned int i = 0; i < PAGE_COUNT; ++i)
+        {
+            pages[i] = other.pages[i];
+            Acquire(pages[i]);
+        }
+    }
+
+    PagedMemory& operator=(PagedMemory const& other)
+    {
+        memcpy(dirty, other.dirty, sizeof(dirty));
+        for (unsigned int i = 0; i < PAGE_COUNT; ++i)
+        {
+            // Snapshots mostly share pages with the live machine, skip those untouched
+            if (pages[i] != other.pages[i])
+            {
+                Acquire(other.pages[i]);
+                Release(pages[i]);
+                pages[i] = other.pages[i];
+            }
+        }
+        return *this;
+    }
+
+    ~PagedMemory()
+    {
+        ReleaseAll();
+    }
+
+    uint8_t operator[](unsigned int address) const
+    {
+        return pages[address >> PAGE_SHIFT]->bytes[address & PAGE_OFFSET_MASK];
+    }
+
+    /**
+     * Read-only view of a page.
+     */
+    [[nodiscard]] uint8_t const* Page(unsigned int page) const
+    {
+        return pages[page]->bytes;
+    }
+
+    /**
+     * Writable view of a page, cloned first if anything else shares it.
+     */
+    uint8_t* MutablePage(unsigned int page)
+    {
+        MemoryPage* current = pages[page];
+
+        if (current->pinned || current->refs.load(std::memory_order_acquire) != 1)
+        {
+            auto* clone = new MemoryPage;
+            memcpy(clone->bytes, current->bytes, PAGE_SIZE);
+            Release(current);
+            pages[page] = clone;
+        }
+
+        return pages[page]->bytes;
+    }
+
+    void Write(unsigned int address, uint8_t value)
+    {
+        dirty[address >> (MEMORY_LINE_SHIFT + 6)] |= 1ull << ((address >> MEMORY_LINE_SHIFT) % 64);
+        MutablePage(address >> PAGE_SHIFT)[address & PAGE_OFFSET_MASK] = value;
+    }
+
+    void Write(unsigned int address, uint8_t const* data, size_t size)
+    {
+        if (size > 0)
+        {
+            MarkDirty(address >> MEMORY_LINE_SHIFT, (address + size - 1) >> MEMORY_LINE_SHIFT);
+        }
+
+        while (size > 0)
+        {
+            const size_t chunk = std::min<size_t>(size, PAGE_SIZE - (address & PAGE_OFFSET_MASK));
+            memcpy(MutablePage(address >> PAGE_SHIFT) + (address & PAGE_OFFSET_MASK), data, chunk);
+            address += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    /**
+     * Call f(line) for every line written since the last ClearDirty, in address order.
+     */
+    template <typename F>
+    void ForEachDirtyLine(F&& f) const
+    {
+        for (unsigned int word = 0; word < LINE_COUNT / 64; ++word)
+        {
+            for (uint64_t bits = dirty[word]; bits; bits &= bits - 1)
+            {
+                f(word * 64 + std::countr_zero(bits));
+            }
+        }
+    }
+
+    void ClearDirty()
+    {
+        memset(dirty, 0, sizeof(dirty));
+    }
+
+    /**
+     * Whether a page is the same physical page as in another memory, i.e. certainly equal.
+     */
+    [[nodiscard]] bool SharesPage(PagedMemory const& other, unsigned int page) const
+    {
+        return pages[page] == other.pages[page];
+    }
+
+    /**
+     * Pages this memory does not share with anything, what a clone of it really costs.
+     */
+    [[nodiscard]] unsigned int PrivatePages() const
+    {
+        return std::count_if(std::begin(pages), std::end(pages), [](MemoryPage* page) {
+            return !page->pinned && page->refs.load(std::memory_order_relaxed) == 1;
+        });
+    }
+
+    /**
+     * Make every page permanent and shared, for process-wide images such as the boot fonts.
+     * The pages are never freed afterwards.
+     */
+    void Pin()
+    {
+        for (MemoryPage* page : pages)
+        {
+            // The zero page is pinned already and read by every thread
+            if (!page->pinned)
+            {
+                page->pinned = true;
+            }
+        }
+    }
+};
+
+#endif //MEMORY_H
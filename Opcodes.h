@@ -0,0 +1,275 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef OPCODES_H
+#define OPCODES_H
+
+#include <cstdint>
+
+/**
+ * Every instruction the core knows, named after its OP_xxxx handler.
+ * TABLEx entries are not instructions, they send decoding to a sub-table.
+ */
+enum class Op : uint8_t
+{
+    OP_NULL,
+    OP_00Cn, OP_00Dn, OP_00E0, OP_00EE, OP_00FB, OP_00FC, OP_00FD, OP_00FE, OP_00FF,
+    OP_1nnn, OP_2nnn, OP_3xkk, OP_4xkk,
+    OP_5xy0, OP_5xy2, OP_5xy3,
+    OP_6xkk, OP_7xkk,
+    OP_8xy0, OP_8xy1, OP_8xy2, OP_8xy3, OP_8xy4, OP_8xy5, OP_8xy6, OP_8xy7, OP_8xyE,
+    OP_9xy0, OP_Annn, OP_Bnnn, OP_Cxkk, OP_Dxyn,
+    OP_Ex9E, OP_ExA1,
+    OP_F000, OP_Fn01, OP_F002, OP_Fx07, OP_Fx0A, OP_Fx15, OP_Fx18, OP_Fx1E, OP_Fx29, OP_Fx30,
+    OP_Fx33, OP_Fx3A, OP_Fx55, OP_Fx65, OP_Fx75, OP_Fx85,
+    TABLE0, TABLE5, TABLE8, TABLEE, TABLEF,
+    COUNT
+};
+
+/**
+ * The decode tables. Chip8 builds its handler tables from these,
+ * so anything else that decodes (analyzer, disassembler) can't drift from the core.
+ * table is indexed by the first nibble, table0/tableF by the low byte,
+ * table5/table8/tableE by the low nibble.
+ */
+struct OpcodeTables
+{
+    Op table[0xF + 1]{};
+    Op table0[0xFF + 1]{};
+    Op table5[0xF + 1]{};
+    Op table8[0xF + 1]{};
+    Op tableE[0xF + 1]{};
+    Op tableF[0xFF + 1]{};
+};
+
+constexpr OpcodeTables MakeOpcodeTables()
+{
+    OpcodeTables t{};
+
+    t.table[0x0] = Op::TABLE0;
+    t.table[0x1] = Op::OP_1nnn;
+    t.table[0x2] = Op::OP_2nnn;
+    t.table[0x3] = Op::OP_3xkk;
+    t.table[0x4] = Op::OP_4xkk;
+    t.table[0x5] = Op::TABLE5;
+    t.table[0x6] = Op::OP_6xkk;
+    t.table[0x7] = Op::OP_7xkk;
+    t.table[0x8] = Op::TABLE8;
+    t.table[0x9] = Op::OP_9xy0;
+    t.table[0xA] = Op::OP_Annn;
+    t.table[0xB] = Op::OP_Bnnn;
+    t.table[0xC] = Op::OP_Cxkk;
+    t.table[0xD] = Op::OP_Dxyn;
+    t.table[0xE] = Op::TABLEE;
+    t.table[0xF] = Op::TABLEF;
+
+    for (unsigned int i = 0xC0; i <= 0xCF; i++)
+    {
+        t.table0[i] = Op::OP_00Cn;
+    }
+
+    for (unsigned int i = 0xD0; i <= 0xDF; i++)
+    {
+        t.table0[i] = Op::OP_00Dn;
+    }
+
+    t.table0[0xE0] = Op::OP_00E0;
+    t.table0[0xEE] = Op::OP_00EE;
+    t.table0[0xFB] = Op::OP_00FB;
+    t.table0[0xFC] = Op::OP_00FC;
+    t.table0[0xFD] = Op::OP_00FD;
+    t.table0[0xFE] = Op::OP_00FE;
+    t.table0[0xFF] = Op::OP_00FF;
+
+    t.table5[0x0] = Op::OP_5xy0;
+    t.table5[0x2] = Op::OP_5xy2;
+    t.table5[0x3] = Op::OP_5xy3;
+
+    t.table8[0x0] = Op::OP_8xy0;
+    t.table8[0x1] = Op::OP_8xy1;
+    t.table8[0x2] = Op::OP_8xy2;
+    t.table8[0x3] = Op::OP_8xy3;
+    t.table8[0x4] = Op::OP_8xy4;
+    t.table8[0x5] = Op::OP_8xy5;
+    t.table8[0x6] = Op::OP_8xy6;
+    t.table8[0x7] = Op::OP_8xy7;
+    t.table8[0xE] = Op::OP_8xyE;
+
+    t.tableE[0x1] = Op::OP_ExA1;
+    t.tableE[0xE] = Op::OP_Ex9E;
+
+    t.tableF[0x00] = Op::OP_F000;
+    t.tableF[0x01] = Op::OP_Fn01;
+    t.tableF[0x02] = Op::OP_F002;
+    t.tableF[0x07] = Op::OP_Fx07;
+    t.tableF[0x0A] = Op::OP_Fx0A;
+    t.tableF[0x15] = Op::OP_Fx15;
+    t.tableF[0x18] = Op::OP_Fx18;
+    t.tableF[0x1E] = Op::OP_Fx1E;
+    t.tableF[0x29] = Op::OP_Fx29;
+    t.tableF[0x30] = Op::OP_Fx30;
+    t.tableF[0x33] = Op::OP_Fx33;
+    t.tableF[0x3A] = Op::OP_Fx3A;
+    t.tableF[0x55] = Op::OP_Fx55;
+    t.tableF[0x65] = Op::OP_Fx65;
+    t.tableF[0x75] = Op::OP_Fx75;
+    t.tableF[0x85] = Op::OP_Fx85;
+
+    return t;
+}
+
+inline constexpr OpcodeTables OPCODE_TABLES = MakeOpcodeTables();
+
+/**
+ * Decode an opcode to its instruction, following the sub-tables.
+ */
+constexpr Op DecodeOp(uint16_t opcode)
+{
+    switch (const Op op = OPCODE_TABLES.table[opcode >> 12u])
+    {
+        case Op::TABLE0: return OPCODE_TABLES.table0[opcode & 0x00FFu];
+        case Op::TABLE5: return OPCODE_TABLES.table5[opcode & 0x000Fu];
+        case Op::TABLE8: return OPCODE_TABLES.table8[opcode & 0x000Fu];
+        case Op::TABLEE: return OPCODE_TABLES.tableE[opcode & 0x000Fu];
+        case Op::TABLEF: return OPCODE_TABLES.tableF[opcode & 0x00FFu];
+        default: return op;
+    }
+}
+
+/**
+ * Handler name of an instruction, e.g. "OP_Dxyn".
+ */
+constexpr char const* OpName(Op op)
+{
+    switch (op)
+    {
+        case Op::OP_NULL: return "OP_NULL";
+        case Op::OP_00Cn: return "OP_00Cn";
+        case Op::OP_00Dn: return "OP_00Dn";
+        case Op::OP_00E0: return "OP_00E0";
+        case Op::OP_00EE: return "OP_00EE";
+        case Op::OP_00FB: return "OP_00FB";
+        case Op::OP_00FC: return "OP_00FC";
+        case Op::OP_00FD: return "OP_00FD";
+        case Op::OP_00FE: return "OP_00FE";
+        case Op::OP_00FF: return "OP_00FF";
+        case Op::OP_1nnn: return "OP_1nnn";
+        case Op::OP_2nnn: return "OP_2nnn";
+        case Op::OP_3xkk: return "OP_3xkk";
+        case Op::OP_4xkk: return "OP_4xkk";
+        case Op::OP_5xy0: return "OP_5xy0";
+        case Op::OP_5xy2: return "OP_5xy2";
+        case Op::OP_5xy3: return "OP_5xy3";
+        case Op::OP_6xkk: return "OP_6xkk";
+        case Op::OP_7xkk: return "OP_7xkk";
+        case Op::OP_8xy0: return "OP_8xy0";
+        case Op::OP_8xy1: return "OP_8xy1";
+        case Op::OP_8xy2: return "OP_8xy2";
+        case Op::OP_8xy3: return "OP_8xy3";
+        case Op::OP_8xy4: return "OP_8xy4";
+        case Op::OP_8xy5: return "OP_8xy5";
+        case Op::OP_8xy6: return "OP_8xy6";
+        case Op::OP_8xy7: return "OP_8xy7";
+        case Op::OP_8xyE: return "OP_8xyE";
+        case Op::OP_9xy0: return "OP_9xy0";
+        case Op::OP_Annn: return "OP_Annn";
+        case Op::OP_Bnnn: return "OP_Bnnn";
+        case Op::OP_Cxkk: return "OP_Cxkk";
+        case Op::OP_Dxyn: return "OP_Dxyn";
+        case Op::OP_Ex9E: return "OP_Ex9E";
+        case Op::OP_ExA1: return "OP_ExA1";
+        case Op::OP_F000: return "OP_F000";
+        case Op::OP_Fn01: return "OP_Fn01";
+        case Op::OP_F002: return "OP_F002";
+        case Op::OP_Fx07: return "OP_Fx07";
+        case Op::OP_Fx0A: return "OP_Fx0A";
+        case Op::OP_Fx15: return "OP_Fx15";
+        case Op::OP_Fx18: return "OP_Fx18";
+        case Op::OP_Fx1E: return "OP_Fx1E";
+        case Op::OP_Fx29: return "OP_Fx29";
+        case Op::OP_Fx30: return "OP_Fx30";
+        case Op::OP_Fx33: return "OP_Fx33";
+        case Op::OP_Fx3A: return "OP_Fx3A";
+        case Op::OP_Fx55: return "OP_Fx55";
+        case Op::OP_Fx65: return "OP_Fx65";
+        case Op::OP_Fx75: return "OP_Fx75";
+        case Op::OP_Fx85: return "OP_Fx85";
+        case Op::TABLE0:
+        case Op::TABLE5:
+        case Op::TABLE8:
+        case Op::TABLEE:
+        case Op::TABLEF:
+        case Op::COUNT: break;
+    }
+
+    return "OP_NULL";
+}
+
+// What an instruction does to control flow and memory, for static analysis
+constexpr uint8_t OP_FLOW_JUMP = 1u << 0u;     // pc = nnn
+constexpr uint8_t OP_FLOW_CALL = 1u << 1u;     // push pc, pc = nnn
+constexpr uint8_t OP_FLOW_RETURN = 1u << 2u;   // pc = pop
+constexpr uint8_t OP_FLOW_SKIP = 1u << 3u;     // may skip the next instruction
+constexpr uint8_t OP_FLOW_COMPUTED = 1u << 4u; // target depends on a register
+constexpr uint8_t OP_FLOW_STOP = 1u << 5u;     // never falls through (exit, invalid)
+constexpr uint8_t OP_MEM_WRITE = 1u << 6u;     // writes memory at I
+constexpr uint8_t OP_MEM_READ = 1u << 7u;      // reads memory at I
+
+constexpr uint8_t OpFlags(Op op)
+{
+    switch (op)
+    {
+        case Op::OP_1nnn: return OP_FLOW_JUMP;
+        case Op::OP_2nnn: return OP_FLOW_CALL;
+        case Op::OP_00EE: return OP_FLOW_RETURN;
+        case Op::OP_Bnnn: return OP_FLOW_COMPUTED;
+        case Op::OP_00FD:
+        case Op::OP_NULL: return OP_FLOW_STOP;
+        case Op::OP_3xkk:
+        case Op::OP_4xkk:
+        case Op::OP_5xy0:
+        case Op::OP_9xy0:
+        case Op::OP_Ex9E:
+        case Op::OP_ExA1: return OP_FLOW_SKIP;
+        case Op::OP_5xy2:
+        case Op::OP_Fx33:
+        case Op::OP_Fx55: return OP_MEM_WRITE;
+        case Op::OP_5xy3:
+        case Op::OP_Dxyn:
+        case Op::OP_F002:
+        case Op::OP_Fx65: return OP_MEM_READ;
+        default: return 0;
+    }
+}
+
+/**
+ * Bytes written or read at I by a memory instruction.
+ */
+constexpr unsigned int OpMemorySpan(Op op, uint16_t opcode)
+{
+    const unsigned int x = (opcode & 0x0F00u) >> 8u;
+    const unsigned int y = (opcode & 0x00F0u) >> 4u;
+
+    switch (op)
+    {
+        case Op::OP_Fx33: return 3;
+        case Op::OP_Fx55:
+        case Op::OP_Fx65: return x + 1;
+        case Op::OP_5xy2:
+        case Op::OP_5xy3: return (x > y ? x - y : y - x) + 1;
+        case Op::OP_F002: return 16;
+        case Op::OP_Dxyn: return (opcode & 0x000Fu) ? (opcode & 0x000Fu) : 32;
+        default: return 0;
+    }
+}
+
+/**
+ * Length of the instruction in bytes, F000 nnnn carries its address inline.
+ */
+constexpr unsigned int OpLength(Op op)
+{
+    return op == Op::OP_F000 ? 4 : 2;
+}
+
+#endif //OPCODES_H
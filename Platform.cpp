@@ -3,41 +3,311 @@
 //
 
 #include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Chip8.h"
+#include "Scaler.cpp"
+#include "Video.cpp"
+
+constexpr int AUDIO_FREQUENCY = 44100;
+constexpr float AUDIO_VOLUME = 0.25f;
 
 class Platform
 {
 	SDL_Window* window{};
 	SDL_Renderer* renderer{};
 	SDL_Texture* texture{};
+	int textureWidth{};
+	int textureHeight{};
+
+	// RGBA8888, indexed by plane 0 bit | plane 1 bit << 1
+	uint32_t palette[4] = {0x000000FF, 0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF};
+
+	// Last display that made it into the texture, so only changed rows get uploaded
+	uint64_t presented[VIDEO_PLANES][HIRES_VIDEO_HEIGHT][VIDEO_ROW_WORDS]{};
+	bool redrawAll = true;
+
+	// Tab pressed since the last SkipRequested, moves a playlist on
+	bool skip{};
+
+	SDL_AudioDeviceID audioDevice{};
+	uint8_t audioPattern[AUDIO_PATTERN_SIZE]{};
+	uint8_t audioPitch{DEFAULT_AUDIO_PITCH};
+	bool audioPlaying{};
+	double audioPhase{};
+
+	/**
+	 * Plays the 128-bit pattern as a 1-bit waveform, looping, while the sound timer runs.
+	 */
+	static void AudioCallback(void* userdata, Uint8* stream, int length)
+	{
+		auto* self = static_cast<Platform*>(userdata);
+		auto* samples = reinterpret_cast<float*>(stream);
+		const int count = length / static_cast<int>(sizeof(float));
+
+		const double step = 4000.0 * std::pow(2.0, (self->audioPitch - 64) / 48.0) / AUDIO_FREQUENCY;
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (!self->audioPlaying)
+			{
+				samples[i] = 0.0f;
+				continue;
+			}
+
+			const unsigned int bit = static_cast<unsigned int>(self->audioPhase) & 127u;
+			const bool high = (self->audioPattern[bit >> 3u] >> (7u - (bit & 7u))) & 1u;
+			samples[i] = high ? AUDIO_VOLUME : -AUDIO_VOLUME;
+
+			self->audioPhase += step;
+			if (self->audioPhase >= 128.0)
+			{
+				self->audioPhase -= 128.0;
+			}
+		}
+	}
+
+	/**
+	 * Swap the texture for one of a new size, the window and renderer stay as they are.
+	 */
+	void ResizeTexture(int width, int height)
+	{
+		SDL_DestroyTexture(texture);
+
+		texture = SDL_CreateTexture(
+			renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+
+		textureWidth = width;
+		textureHeight = height;
+		redrawAll = true;
+	}
 public:
 	Platform(char const* title, int windowWidth, int windowHeight, int textureWidth, int textureHeight)
 	{
-		SDL_Init(SDL_INIT_VIDEO);
+		SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
 
 		window = SDL_CreateWindow(title, 0, 0, windowWidth, windowHeight, SDL_WINDOW_SHOWN);
 
 		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+		// No GPU, SDL's own software renderer still shows what SoftwareScaler drew
+		if (!renderer)
+		{
+			renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+		}
 
-		texture = SDL_CreateTexture(
-			renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, textureWidth, textureHeight);
+		ResizeTexture(textureWidth, textureHeight);
+
+		SDL_AudioSpec want{};
+		want.freq = AUDIO_FREQUENCY;
+		want.format = AUDIO_F32SYS;
+		want.channels = 1;
+		want.samples = 512;
+		want.callback = AudioCallback;
+		want.userdata = this;
+
+		// No sound is fine, the emulator still runs
+		audioDevice = SDL_OpenAudioDevice(nullptr, 0, &want, nullptr, 0);
+		if (audioDevice)
+		{
+			SDL_PauseAudioDevice(audioDevice, 0);
+		}
 	}
 
 	~Platform()
 	{
+		if (audioDevice)
+		{
+			SDL_CloseAudioDevice(audioDevice);
+		}
+
 		SDL_DestroyTexture(texture);
 		SDL_DestroyRenderer(renderer);
 		SDL_DestroyWindow(window);
 		SDL_Quit();
 	}
 
-	void Update(void const* buffer, int pitch)
+	/**
+	 * Set the colours used for the display, as RGBA8888.
+	 * With two colours any lit plane uses the second one,
+	 * with four they are indexed by plane 0 bit | plane 1 bit << 1.
+	 */
+	void SetPalette(uint32_t const* colors, int count)
+	{
+		palette[0] = colors[0];
+		palette[1] = colors[1];
+		palette[2] = count >= 4 ? colors[2] : colors[1];
+		palette[3] = count >= 4 ? colors[3] : colors[1];
+		redrawAll = true;
+	}
+
+	/**
+	 * Present the packed display planes.
+	 * Rows are expanded straight into the locked streaming texture,
+	 * and only the band between the first and last changed row is locked and written.
+	 * @param video VIDEO_PLANES planes laid out as in Chip8::video
+	 * @param width display width, the texture follows it when it changes
+	 * @param height display height
+	 */
+	void Update(uint64_t const* video, int width, int height)
+	{
+		if (width != textureWidth || height != textureHeight)
+		{
+			ResizeTexture(width, height);
+		}
+
+		int firstRow = height;
+		int lastRow = -1;
+
+		for (int y = 0; y < height; ++y)
+		{
+			bool changed = redrawAll;
+
+			for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+			{
+				uint64_t const* row = video + plane * VIDEO_PLANE_WORDS + static_cast<size_t>(y) * VIDEO_ROW_WORDS;
+
+				if (memcmp(presented[plane][y], row, sizeof(presented[plane][y])) != 0)
+				{
+					memcpy(presented[plane][y], row, sizeof(presented[plane][y]));
+					changed = true;
+				}
+			}
+
+			if (changed)
+			{
+				firstRow = std::min(firstRow, y);
+				lastRow = y;
+			}
+		}
+
+		if (lastRow >= firstRow)
+		{
+			const SDL_Rect band{0, firstRow, width, lastRow - firstRow + 1};
+			void* locked;
+			int pitch;
+
+			if (SDL_LockTexture(texture, &band, &locked, &pitch) == 0)
+			{
+				for (int y = firstRow; y <= lastRow; ++y)
+				{
+					auto* out = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(locked) + static_cast<ptrdiff_t>(y - firstRow) * pitch);
+					ExpandRow(presented[0][y], presented[1][y], width, palette, out);
+				}
+
+				SDL_UnlockTexture(texture);
+				redrawAll = false;
+			}
+		}
+
+		SDL_RenderClear(renderer);
+		SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+		SDL_RenderPresent(renderer);
+	}
+
+	/**
+	 * Present finished RGBA8888 pixels, such as the compositor's, in one texture upload.
+	 * @param pixels width x height pixels, rows packed
+	 */
+	void Present(uint32_t const* pixels, int width, int height)
 	{
-		SDL_UpdateTexture(texture, nullptr, buffer, pitch);
+		if (width != textureWidth || height != textureHeight)
+		{
+			ResizeTexture(width, height);
+		}
+
+		SDL_UpdateTexture(texture, nullptr, pixels, width * static_cast<int>(sizeof(uint32_t)));
+		// The texture no longer shows what Update last compared against
+		redrawAll = true;
+
 		SDL_RenderClear(renderer);
 		SDL_RenderCopy(renderer, texture, nullptr, nullptr);
 		SDL_RenderPresent(renderer);
 	}
 
+	/**
+	 * Present RGBA8888 pixels scaled on the CPU to the full output, for renderers that
+	 * cannot scale well or at all. The scaler writes straight into the locked texture.
+	 * @param pixels width x height pixels, rows packed
+	 */
+	void PresentScaled(SoftwareScaler& scaler, uint32_t const* pixels, int width, int height)
+	{
+		int outputWidth;
+		int outputHeight;
+		OutputSize(outputWidth, outputHeight);
+		if (outputWidth != textureWidth || outputHeight != textureHeight)
+		{
+			ResizeTexture(outputWidth, outputHeight);
+		}
+
+		void* locked;
+		int pitch;
+		if (SDL_LockTexture(texture, nullptr, &locked, &pitch) == 0)
+		{
+			scaler.Scale(pixels, width, height, static_cast<uint32_t*>(locked), outputWidth, outputHeight,
+				pitch / sizeof(uint32_t));
+			SDL_UnlockTexture(texture);
+		}
+		redrawAll = true;
+
+		SDL_RenderClear(renderer);
+		SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+		SDL_RenderPresent(renderer);
+	}
+
+	/**
+	 * Expand the packed display planes to RGBA8888 with the current palette.
+	 * @param out width x height pixels, rows packed
+	 */
+	void Expand(uint64_t const* video, int width, int height, uint32_t* out) const
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			uint64_t const* row = video + static_cast<size_t>(y) * VIDEO_ROW_WORDS;
+			ExpandRow(row, row + VIDEO_PLANE_WORDS, width, palette, out + static_cast<size_t>(y) * width);
+		}
+	}
+
+	/**
+	 * Size in pixels of what the renderer draws to, the target for scaling on the CPU.
+	 */
+	void OutputSize(int& width, int& height) const
+	{
+		SDL_GetRendererOutputSize(renderer, &width, &height);
+	}
+
+	void SetTitle(char const* title)
+	{
+		SDL_SetWindowTitle(window, title);
+	}
+
+	/**
+	 * Whether Tab was pressed since the last call.
+	 */
+	bool SkipRequested()
+	{
+		const bool requested = skip;
+		skip = false;
+		return requested;
+	}
+
+	/**
+	 * Hand the current sound state to the audio thread.
+	 */
+	void UpdateAudio(uint8_t const* pattern, uint8_t pitch, bool playing)
+	{
+		if (!audioDevice)
+		{
+			return;
+		}
+
+		SDL_LockAudioDevice(audioDevice);
+		memcpy(audioPattern, pattern, AUDIO_PATTERN_SIZE);
+		audioPitch = pitch;
+		audioPlaying = playing;
+		SDL_UnlockAudioDevice(audioDevice);
+	}
+
 	bool ProcessInput(uint8_t* keys)
 	{
 		bool quit = false;
@@ -62,6 +332,11 @@ public:
 							quit = true;
 						} break;
 
+						case SDLK_TAB:
+						{
+							skip = true;
+						} break;
+
 						case SDLK_x:
 						{
 							keys[0] = 1;
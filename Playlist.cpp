@@ -0,0 +1,171 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef PLAYLIST_CPP
+#define PLAYLIST_CPP
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+#include "Analyzer.cpp"
+#include "Chip8.cpp"
+#include "MappedFile.cpp"
+#include "RomLibrary.cpp"
+
+/**
+ * A ROM made ready to play: a machine booted with it, and what the library knows about it.
+ * Switching to it is one Chip8::LoadState.
+ */
+struct PreparedRom
+{
+    std::string path;
+    // Library title, or the file name for ROMs the library does not know
+    std::string title;
+    // Saved settings from the library, zero when unknown
+    RomSettings settings{};
+    // Power-on state with the ROM in memory
+    Chip8State boot;
+    // Reachable opcodes the core does not implement, the ROM would stop on them
+    size_t invalidOpcodes{};
+    bool loaded{};
+};
+
+/**
+ * ROMs played one after the other, for attract mode on a kiosk.
+ * While one plays the next is read, booted and analyzed on a background thread,
+ * so moving on costs one state copy within a frame, not a load or a new Chip8 and Platform.
+ * ROMs that fail to load or would run into an unimplemented opcode are skipped.
+ */
+class RomPlaylist
+{
+    RomLibrary const& library;
+    std::vector<std::string> paths;
+    size_t next{};
+    std::future<PreparedRom> pending;
+
+    void Preload()
+    {
+        const std::string path = paths[next];
+        next = (next + 1) % paths.size();
+        pending = std::async(std::launch::async, [this, path] { return Prepare(path, library); });
+    }
+
+public:
+    explicit RomPlaylist(RomLibrary const& library) : library(library) {}
+
+    /**
+     * Load, boot and analyze one ROM. Safe on any thread, the library is only read.
+     */
+    static PreparedRom Prepare(std::string const& path, RomLibrary const& library)
+    {
+        PreparedRom prepared;
+        prepared.path = path;
+
+        const MappedFile file(path.c_str());
+        if (!file.IsOpen() || file.Size() == 0)
+        {
+            return prepared;
+        }
+
+        Chip8 machine;
+        machine.LoadROM(file.Data(), file.Size());
+        machine.SaveState(prepared.boot);
+
+        prepared.invalidOpcodes = Analyzer::Analyze(file.Data(), std::min<size_t>(file.Size(), MAX_ROM_SIZE)).invalid.size();
+
+        if (RomEntry const* entry = library.Find(HashRom(file.Data(), file.Size())))
+        {
+            prepared.title = entry->title;
+            prepared.settings = entry->settings;
+        }
+        else
+        {
+            prepared.title = std::filesystem::path(path).stem().string();
+        }
+
+        prepared.loaded = true;
+        return prepared;
+    }
+
+    /**
+     * Add a ROM, every .ch8 under a directory in name order, or a list file of either,
+     * one per line relative to the list, # for comments.
+     * @return false if nothing was added
+     */
+    bool Add(std::string const& source)
+    {
+        std::error_code error;
+        const std::filesystem::path path(source);
+        const size_t before = paths.size();
+
+        if (std::filesystem::is_directory(path, error))
+        {
+            std::vector<std::string> found;
+            for (auto const& item : std::filesystem::recursive_directory_iterator(path, error))
+            {
+                if (item.is_regular_file() && item.path().extension() == ".ch8")
+                {
+                    found.push_back(item.path().string());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            paths.insert(paths.end(), found.begin(), found.end());
+        }
+        else if (path.extension() == ".ch8")
+        {
+            paths.push_back(source);
+        }
+        else
+        {
+            std::ifstream list(path);
+            std::string line;
+            while (std::getline(list, line))
+            {
+                line.erase(line.find_last_not_of(" \t\r") + 1);
+                if (!line.empty() && line[0] != '#')
+                {
+                    Add((path.parent_path() / line).string());
+                }
+            }
+        }
+
+        return paths.size() > before;
+    }
+
+    [[nodiscard]] size_t Size() const
+    {
+        return paths.size();
+    }
+
+    /**
+     * The next playable ROM, usually prepared already, and start preparing the one after.
+     * The first call waits for its ROM to be prepared.
+     * @return false if no ROM in the playlist is playable
+     */
+    bool Next(PreparedRom& rom)
+    {
+        for (size_t tried = 0; tried < paths.size(); ++tried)
+        {
+            if (!pending.valid())
+            {
+                Preload();
+            }
+
+            PreparedRom prepared = pending.get();
+            Preload();
+
+            if (prepared.loaded && prepared.invalidOpcodes == 0)
+            {
+                rom = std::move(prepared);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif //PLAYLIST_CPP
@@ -0,0 +1,262 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef PROFILER_CPP
+#define PROFILER_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Chip8.cpp"
+#include "Opcodes.h"
+
+// Deeper calls are charged to the deepest frame, keeps ROMs that call without returning bounded
+constexpr unsigned int PROFILER_MAX_DEPTH = 64;
+
+struct FunctionProfile
+{
+    uint16_t address{};
+    // Instructions executed in the function itself
+    uint64_t exclusive{};
+    // Instructions executed in it and everything it called, recursion counted once
+    uint64_t inclusive{};
+    uint64_t calls{};
+};
+
+/**
+ * Attributes executed instructions to guest subroutines.
+ * 2nnn and 00EE drive a shadow call stack, kept as a call tree with a count per node,
+ * so the totals per distinct stack come out directly in folded-stack form.
+ */
+class Profiler
+{
+    struct Node
+    {
+        uint16_t address{};
+        uint32_t parent{};
+        uint32_t depth{};
+        uint64_t count{};
+        uint64_t calls{};
+        std::vector<uint32_t> children{};
+    };
+
+    // Node 0 is the program entry
+    std::vector<Node> nodes{Node{START_ADDRESS}};
+    uint32_t current{};
+    // Calls made past PROFILER_MAX_DEPTH, their returns must not pop a real frame
+    uint32_t overflow{};
+
+    uint32_t Child(uint32_t parent, uint16_t address)
+    {
+        for (const uint32_t child : nodes[parent].children)
+        {
+            if (nodes[child].address == address)
+            {
+                return child;
+            }
+        }
+
+        const auto child = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{address, parent, nodes[parent].depth + 1});
+        nodes[parent].children.push_back(child);
+        return child;
+    }
+
+    [[nodiscard]] std::string FrameName(uint16_t address) const
+    {
+        char name[16];
+        std::snprintf(name, sizeof(name), address == START_ADDRESS ? "start_%03X" : "sub_%03X", address);
+        return name;
+    }
+
+    void Fold(uint32_t node, std::string const& prefix, FILE* out) const
+    {
+        const std::string stack = prefix.empty() ? FrameName(nodes[node].address)
+                                                 : prefix + ";" + FrameName(nodes[node].address);
+        if (nodes[node].count)
+        {
+            std::fprintf(out, "%s %llu\n", stack.c_str(), static_cast<unsigned long long>(nodes[node].count));
+        }
+        for (const uint32_t child : nodes[node].children)
+        {
+            Fold(child, stack, out);
+        }
+    }
+
+    [[nodiscard]] uint64_t Subtree(uint32_t node) const
+    {
+        uint64_t total = nodes[node].count;
+        for (const uint32_t child : nodes[node].children)
+        {
+            total += Subtree(child);
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool HasAncestor(uint32_t node, uint16_t address) const
+    {
+        for (uint32_t parent = node; parent != 0;)
+        {
+            parent = nodes[parent].parent;
+            if (nodes[parent].address == address)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    /**
+     * Run one instruction and charge it to the current guest function.
+     */
+    void Step(Chip8& chip8)
+    {
+        Execute(chip8);
+        chip8.TickTimers();
+    }
+
+    /**
+     * Step without the timer tick, for timed frames that tick once per frame.
+     */
+    void Execute(Chip8& chip8)
+    {
+        const uint16_t pc = chip8.pc;
+        const Op op = DecodeOp((chip8.memory[pc & MEMORY_MASK] << 8u) | chip8.memory[(pc + 1) & MEMORY_MASK]);
+
+        chip8.Execute();
+
+        // A Dxyn stalled for the vblank did not run, it is counted once it draws
+        if (chip8.waitingForVblank)
+        {
+            return;
+        }
+        ++nodes[current].count;
+
+        if (op == Op::OP_2nnn)
+        {
+            if (nodes[current].depth < PROFILER_MAX_DEPTH)
+            {
+                current = Child(current, chip8.pc);
+                ++nodes[current].calls;
+            }
+            else
+            {
+                ++overflow;
+            }
+        }
+        else if (op == Op::OP_00EE)
+        {
+            if (overflow)
+            {
+                --overflow;
+            }
+            else if (current != 0)
+            {
+                current = nodes[current].parent;
+            }
+        }
+    }
+
+    void RunFrame(Chip8& chip8, unsigned int cycles)
+    {
+        for (unsigned int i = 0; i < cycles; ++i)
+        {
+            Step(chip8);
+
+            // As in Chip8::RunFrame, the stalled Dxyn is not charged for the rest of the frame
+            if (chip8.waitingForVblank)
+            {
+                for (++i; i < cycles; ++i)
+                {
+                    chip8.TickTimers();
+                }
+            }
+        }
+        chip8.Vblank();
+    }
+
+    unsigned int RunTimedFrame(Chip8& chip8, TimingMode mode)
+    {
+        return chip8.RunTimedFrame(mode, [&]() { Execute(chip8); });
+    }
+
+    /**
+     * Write one line per distinct call stack with its instruction count,
+     * the folded format flamegraph.pl and speedscope read.
+     */
+    void WriteFolded(FILE* out) const
+    {
+        Fold(0, "", out);
+    }
+
+    [[nodiscard]] bool WriteFolded(char const* filename) const
+    {
+        FILE* out = std::fopen(filename, "w");
+        if (!out)
+        {
+            return false;
+        }
+
+        WriteFolded(out);
+        std::fclose(out);
+        return true;
+    }
+
+    /**
+     * Totals per guest function, heaviest inclusive first.
+     */
+    [[nodiscard]] std::vector<FunctionProfile> Functions() const
+    {
+        std::vector<FunctionProfile> functions;
+
+        auto find = [&](uint16_t address) -> FunctionProfile& {
+            for (FunctionProfile& function : functions)
+            {
+                if (function.address == address)
+                {
+                    return function;
+                }
+            }
+            return functions.emplace_back(FunctionProfile{address});
+        };
+
+        for (uint32_t node = 0; node < nodes.size(); ++node)
+        {
+            FunctionProfile& function = find(nodes[node].address);
+            function.exclusive += nodes[node].count;
+            function.calls += nodes[node].calls;
+
+            // A recursive call is already inside the outer call's subtree
+            if (!HasAncestor(node, nodes[node].address))
+            {
+                function.inclusive += Subtree(node);
+            }
+        }
+
+        std::sort(functions.begin(), functions.end(), [](FunctionProfile const& a, FunctionProfile const& b) {
+            return a.inclusive > b.inclusive;
+        });
+        return functions;
+    }
+
+    void PrintSummary(FILE* out) const
+    {
+        const uint64_t total = std::max<uint64_t>(1, Subtree(0));
+
+        std::fprintf(out, "Function   Inclusive          Exclusive          Calls\n");
+        for (FunctionProfile const& function : Functions())
+        {
+            std::fprintf(out, "%-9s  %10llu %5.1f%%  %10llu %5.1f%%  %llu\n",
+                         FrameName(function.address).c_str(),
+                         static_cast<unsigned long long>(function.inclusive), 100.0 * function.inclusive / total,
+                         static_cast<unsigned long long>(function.exclusive), 100.0 * function.exclusive / total,
+                         static_cast<unsigned long long>(function.calls));
+        }
+    }
+};
+
+#endif //PROFILER_CPP
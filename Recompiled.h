@@ -0,0 +1,33 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef RECOMPILED_H
+#define RECOMPILED_H
+
+#include <cstddef>
+#include <cstdint>
+
+class Chip8;
+
+// Everything below is defined by the translation unit Chip8_Recompiler generates for a ROM
+
+/**
+ * Run the compiled basic block that starts at chip8.pc.
+ * When no block starts there (computed jump, code the analyzer never reached)
+ * it runs a single interpreted cycle instead.
+ * @return instructions executed
+ */
+unsigned int RunRecompiledBlock(Chip8& chip8);
+
+/**
+ * Instructions in the compiled block starting at pc, 0 if none starts there.
+ * A block can still stop early, e.g. waiting in Fx0A.
+ */
+unsigned int RecompiledBlockLength(uint16_t pc);
+
+extern const uint8_t RECOMPILED_ROM[];
+extern const size_t RECOMPILED_ROM_SIZE;
+extern char const* const RECOMPILED_ROM_NAME;
+
+#endif //RECOMPILED_H
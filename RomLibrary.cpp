@@ -0,0 +1,268 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ROMLIBRARY_CPP
+#define ROMLIBRARY_CPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include "MappedFile.cpp"
+
+constexpr uint32_t ROM_INDEX_MAGIC = 0x58493843; // "C8IX"
+constexpr uint32_t ROM_INDEX_VERSION = 1;
+constexpr char const* ROM_INDEX_FILE = "roms/roms.idx";
+
+/**
+ * 64-bit FNV-1a over the ROM image.
+ * ROMs are at most a few KB so this is never the bottleneck,
+ * and it needs no third party code.
+ */
+inline uint64_t HashRom(uint8_t const* data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+/**
+ * Per-ROM settings, zero means "use whatever was passed on the command line".
+ */
+struct RomSettings
+{
+    uint32_t videoScale{};
+    uint32_t cycleDelay{};
+};
+
+struct RomEntry
+{
+    uint64_t hash{};
+    uint32_t size{};
+    RomSettings settings{};
+    std::string path;
+    std::string title;
+    std::string notes;
+};
+
+/**
+ * Collection of known ROMs keyed by content hash.
+ * Built once by scanning a directory, then persisted to a single index file
+ * so later startups only read that file.
+ */
+class RomLibrary
+{
+    std::unordered_map<uint64_t, RomEntry> entries;
+
+    static void WriteU32(std::ofstream& out, uint32_t value)
+    {
+        out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    static void WriteString(std::ofstream& out, std::string const& value)
+    {
+        WriteU32(out, static_cast<uint32_t>(value.size()));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    /**
+     * Bounds checked little reader over the mapped index.
+     */
+    struct Reader
+    {
+        uint8_t const* pos;
+        uint8_t const* end;
+        bool ok = true;
+
+        template <typename T>
+        T Read()
+        {
+            T value{};
+            if (end - pos < static_cast<std::ptrdiff_t>(sizeof(T)))
+            {
+                ok = false;
+                return value;
+            }
+            memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        std::string ReadString()
+        {
+            const auto length = Read<uint32_t>();
+            if (!ok || static_cast<size_t>(end - pos) < length)
+            {
+                ok = false;
+                return {};
+            }
+            std::string value(reinterpret_cast<char const*>(pos), length);
+            pos += length;
+            return value;
+        }
+    };
+
+public:
+    /**
+     * Read an index written by Save.
+     * @return false if the file is missing or not a valid index
+     */
+    bool Load(char const* indexFile)
+    {
+        const MappedFile file(indexFile);
+        if (!file.IsOpen())
+        {
+            return false;
+        }
+
+        Reader reader{file.Data(), file.Data() + file.Size()};
+
+        if (reader.Read<uint32_t>() != ROM_INDEX_MAGIC || reader.Read<uint32_t>() != ROM_INDEX_VERSION)
+        {
+            return false;
+        }
+
+        const auto count = reader.Read<uint32_t>();
+        std::unordered_map<uint64_t, RomEntry> loaded;
+        loaded.reserve(count);
+
+        for (uint32_t i = 0; i < count && reader.ok; ++i)
+        {
+            RomEntry entry;
+            entry.hash = reader.Read<uint64_t>();
+            entry.size = reader.Read<uint32_t>();
+            entry.settings.videoScale = reader.Read<uint32_t>();
+            entry.settings.cycleDelay = reader.Read<uint32_t>();
+            entry.path = reader.ReadString();
+            entry.title = reader.ReadString();
+            entry.notes = reader.ReadString();
+            loaded[entry.hash] = std::move(entry);
+        }
+
+        if (!reader.ok)
+        {
+            return false;
+        }
+
+        entries = std::move(loaded);
+        return true;
+    }
+
+    /**
+     * Write every entry to a single index file.
+     */
+    bool Save(char const* indexFile) const
+    {
+        std::ofstream out(indexFile, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        WriteU32(out, ROM_INDEX_MAGIC);
+        WriteU32(out, ROM_INDEX_VERSION);
+        WriteU32(out, static_cast<uint32_t>(entries.size()));
+
+        for (const auto& [hash, entry] : entries)
+        {
+            out.write(reinterpret_cast<char const*>(&hash), sizeof(hash));
+            WriteU32(out, entry.size);
+            WriteU32(out, entry.settings.videoScale);
+            WriteU32(out, entry.settings.cycleDelay);
+            WriteString(out, entry.path);
+            WriteString(out, entry.title);
+            WriteString(out, entry.notes);
+        }
+
+        return out.good();
+    }
+
+    /**
+     * Add one ROM file, or refresh its entry if it is already indexed.
+     * Notes come from the sidecar .txt with the same name, when there is one.
+     * Settings already stored for the ROM are kept.
+     * @return the entry, nullptr if the file cannot be read
+     */
+    RomEntry* Add(std::filesystem::path const& file)
+    {
+        const MappedFile rom(file.string().c_str());
+        if (!rom.IsOpen())
+        {
+            return nullptr;
+        }
+
+        const uint64_t hash = HashRom(rom.Data(), rom.Size());
+
+        RomEntry& entry = entries[hash];
+        entry.hash = hash;
+        entry.size = static_cast<uint32_t>(rom.Size());
+        entry.path = file.generic_string();
+        entry.title = file.stem().string();
+        entry.notes.clear();
+
+        std::filesystem::path sidecar = file;
+        sidecar.replace_extension(".txt");
+
+        if (const MappedFile notes(sidecar.string().c_str()); notes.IsOpen())
+        {
+            entry.notes.assign(reinterpret_cast<char const*>(notes.Data()), notes.Size());
+        }
+
+        return &entry;
+    }
+
+    /**
+     * Rebuild the index from every .ch8 file in a directory tree.
+     * ROMs no longer there are dropped, only the settings of those still there carry over.
+     */
+    void Scan(std::filesystem::path const& directory)
+    {
+        std::unordered_map<uint64_t, RomEntry> previous = std::move(entries);
+        entries.clear();
+        std::error_code error;
+
+        for (const auto& item : std::filesystem::recursive_directory_iterator(directory, error))
+        {
+            if (!item.is_regular_file() || item.path().extension() != ".ch8")
+            {
+                continue;
+            }
+
+            if (RomEntry* entry = Add(item.path()))
+            {
+                if (const auto found = previous.find(entry->hash); found != previous.end())
+                {
+                    entry->settings = found->second.settings;
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] RomEntry const* Find(uint64_t hash) const
+    {
+        const auto found = entries.find(hash);
+        return found == entries.end() ? nullptr : &found->second;
+    }
+
+    RomEntry* Find(uint64_t hash)
+    {
+        const auto found = entries.find(hash);
+        return found == entries.end() ? nullptr : &found->second;
+    }
+
+    [[nodiscard]] std::unordered_map<uint64_t, RomEntry> const& Entries() const
+    {
+        return entries;
+    }
+};
+
+#endif //ROMLIBRARY_CPP
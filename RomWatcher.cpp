@@ -0,0 +1,120 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef ROM_WATCHER_CPP
+#define ROM_WATCHER_CPP
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Elsewhere the modification time is polled, once every this many calls
+constexpr unsigned int ROM_WATCH_POLL_INTERVAL = 30;
+
+/**
+ * Tells when a ROM file has been rewritten, for reloading it in place while it is developed.
+ * On Linux an inotify watch on the file's directory, non-blocking, so checking every frame
+ * is one failed read. The directory rather than the file, since assemblers and editors often
+ * write a new file and rename it over the old one. Elsewhere the modification time is polled.
+ */
+class RomWatcher
+{
+    std::filesystem::path path;
+    std::filesystem::file_time_type lastWrite{};
+    unsigned int calls{};
+
+#ifdef __linux__
+    int inotify = -1;
+#endif
+
+    [[nodiscard]] std::filesystem::file_time_type WriteTime() const
+    {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(path, error);
+        return error ? lastWrite : time;
+    }
+
+public:
+    explicit RomWatcher(char const* filename) : path(filename)
+    {
+        lastWrite = WriteTime();
+
+#ifdef __linux__
+        inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify >= 0)
+        {
+            std::filesystem::path directory = path.parent_path();
+            if (directory.empty())
+            {
+                directory = ".";
+            }
+
+            // Finished writes and files renamed into place, not every partial write
+            if (inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+            {
+                close(inotify);
+                inotify = -1;
+            }
+        }
+#endif
+    }
+
+    ~RomWatcher()
+    {
+#ifdef __linux__
+        if (inotify >= 0)
+        {
+            close(inotify);
+        }
+#endif
+    }
+
+    RomWatcher(RomWatcher const&) = delete;
+    RomWatcher& operator=(RomWatcher const&) = delete;
+
+    /**
+     * Whether the file was rewritten since the last call. Cheap enough to call every frame.
+     */
+    bool Changed()
+    {
+#ifdef __linux__
+        if (inotify >= 0)
+        {
+            const std::string name = path.filename().string();
+            bool changed = false;
+
+            alignas(inotify_event) char events[4096];
+            ssize_t length;
+            while ((length = read(inotify, events, sizeof(events))) > 0)
+            {
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    auto const* event = reinterpret_cast<inotify_event const*>(events + offset);
+                    changed |= event->len > 0 && name == event->name;
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+            return changed;
+        }
+#endif
+
+        if (++calls < ROM_WATCH_POLL_INTERVAL)
+        {
+            return false;
+        }
+        calls = 0;
+
+        const auto time = WriteTime();
+        const bool changed = time != lastWrite;
+        lastWrite = time;
+        return changed;
+    }
+};
+
+#endif //ROM_WATCHER_CPP
@@ -0,0 +1,372 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef SCALER_CPP
+#define SCALER_CPP
+
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Chip8.h"
+#include "Video.cpp"
+
+/**
+ * Nearest: stretch to fill the output.
+ * Integer: the largest whole multiple that fits, centred with black borders.
+ * PixelArt: Scale2x (EPX) once or twice to round off diagonals, then nearest to fill.
+ */
+enum class ScaleFilter : uint8_t
+{
+    Nearest,
+    Integer,
+    PixelArt
+};
+
+/**
+ * Scanlines darken the edges of every source row.
+ * Crt adds an aperture grille, each output column favouring red, green or blue.
+ */
+enum class ScaleEffect : uint8_t
+{
+    None,
+    Scanlines,
+    Crt
+};
+
+// Pixel-art prescale never goes beyond 4x, the display is 128x64 at most
+constexpr unsigned int SCALER_MAX_PRESCALE = 4;
+constexpr uint32_t SCALER_BORDER = 0x000000FF;
+
+/**
+ * CPU-only scaling from the display's RGBA to the window's, for machines where SDL has
+ * no GPU to scale the texture with. Output rows are split into bands, one per thread,
+ * on a persistent pool synchronised like Chip8Env's. A band expands each source row once,
+ * filling runs of equal pixels with SIMD stores, and reuses it for every output row that
+ * maps to the same source row, so most rows are a copy or one multiply pass.
+ */
+class SoftwareScaler
+{
+    ScaleFilter filter;
+    ScaleEffect effect;
+    float strength;
+
+    // Per-frame arguments for the workers
+    uint32_t const* source{};
+    unsigned int sourceWidth{};
+    unsigned int sourceHeight{};
+    uint32_t* dest{};
+    size_t destPitch{};
+    unsigned int destWidth{};
+    unsigned int destHeight{};
+
+    // Layout, rebuilt when a size changes
+    unsigned int prescale{1};
+    std::vector<uint32_t> half;
+    std::vector<uint32_t> upscaled;
+    unsigned int areaX{}, areaY{}, areaWidth{}, areaHeight{};
+    // Per output column of the area, which source column it shows
+    std::vector<uint16_t> columns;
+    // Per output row of the area, which source row it shows and how bright it is, 0-256
+    std::vector<uint16_t> rows;
+    std::vector<uint16_t> rowFactor;
+    // Per output column of the area, A B G R multipliers of the aperture grille, 0-256
+    std::vector<uint16_t> grille;
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<std::barrier<>> start;
+    std::unique_ptr<std::barrier<>> finish;
+    bool stopping{};
+
+    static void Scale2x(uint32_t const* in, unsigned int width, unsigned int height, uint32_t* out)
+    {
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            for (unsigned int x = 0; x < width; ++x)
+            {
+                const uint32_t p = in[y * width + x];
+                const uint32_t a = y > 0 ? in[(y - 1) * width + x] : p;
+                const uint32_t b = x + 1 < width ? in[y * width + x + 1] : p;
+                const uint32_t c = x > 0 ? in[y * width + x - 1] : p;
+                const uint32_t d = y + 1 < height ? in[(y + 1) * width + x] : p;
+
+                uint32_t* o = out + 2 * y * 2 * width + 2 * x;
+                o[0] = c == a && c != d && a != b ? a : p;
+                o[1] = a == b && a != c && b != d ? b : p;
+                o[2 * width] = d == c && d != b && c != a ? c : p;
+                o[2 * width + 1] = b == d && b != a && d != c ? d : p;
+            }
+        }
+    }
+
+    void Layout()
+    {
+        prescale = 1;
+        if (filter == ScaleFilter::PixelArt)
+        {
+            while (prescale < SCALER_MAX_PRESCALE &&
+                   sourceWidth * prescale * 2 <= destWidth && sourceHeight * prescale * 2 <= destHeight)
+            {
+                prescale *= 2;
+            }
+        }
+
+        areaX = areaY = 0;
+        areaWidth = destWidth;
+        areaHeight = destHeight;
+        if (filter == ScaleFilter::Integer)
+        {
+            const unsigned int factor = std::max(1u, std::min(destWidth / sourceWidth, destHeight / sourceHeight));
+            areaWidth = std::min(destWidth, sourceWidth * factor);
+            areaHeight = std::min(destHeight, sourceHeight * factor);
+            areaX = (destWidth - areaWidth) / 2;
+            areaY = (destHeight - areaHeight) / 2;
+        }
+
+        const unsigned int scaledWidth = sourceWidth * prescale;
+        const unsigned int scaledHeight = sourceHeight * prescale;
+
+        columns.resize(areaWidth);
+        grille.resize(areaWidth * 4);
+        for (unsigned int x = 0; x < areaWidth; ++x)
+        {
+            columns[x] = static_cast<uint16_t>(x * scaledWidth / areaWidth);
+
+            // A B G R, the grille keeps one of R, G, B whole and dims the others
+            const auto dim = static_cast<uint16_t>(effect == ScaleEffect::Crt ? 256 - 96 * strength : 256);
+            const unsigned int keep = 3 - x % 3;
+            for (unsigned int channel = 0; channel < 4; ++channel)
+            {
+                grille[x * 4 + channel] = channel == 0 || channel == keep ? 256 : dim;
+            }
+        }
+
+        rows.resize(areaHeight);
+        rowFactor.resize(areaHeight);
+        for (unsigned int y = 0; y < areaHeight; ++y)
+        {
+            rows[y] = static_cast<uint16_t>(y * scaledHeight / areaHeight);
+
+            // Bright in the middle of each source row, dark at its edges
+            const float position = (y + 0.5f) * sourceHeight / areaHeight;
+            const float edge = 2.0f * (position - std::floor(position)) - 1.0f;
+            const float brightness = effect == ScaleEffect::None ? 1.0f : 1.0f - strength * edge * edge;
+            rowFactor[y] = static_cast<uint16_t>(brightness * 256.0f);
+        }
+
+        upscaled.resize(static_cast<size_t>(scaledWidth) * scaledHeight);
+    }
+
+    /**
+     * One source row to one area row, every run of equal output pixels filled at once.
+     */
+    void ExpandLine(uint32_t const* in, uint32_t* out) const
+    {
+        for (unsigned int x = 0; x < areaWidth;)
+        {
+            const uint16_t column = columns[x];
+            unsigned int end = x + 1;
+            while (end < areaWidth && columns[end] == column)
+            {
+                ++end;
+            }
+
+#ifdef CHIP8_VIDEO_SSE2
+            const __m128i color = _mm_set1_epi32(static_cast<int>(in[column]));
+            for (; x + 4 <= end; x += 4)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), color);
+            }
+#endif
+            for (; x < end; ++x)
+            {
+                out[x] = in[column];
+            }
+        }
+    }
+
+    /**
+     * Scanline brightness and grille on one row: each channel times factor times its grille weight.
+     */
+    void ShadeLine(uint32_t const* in, uint32_t* out, uint16_t factor) const
+    {
+#ifdef CHIP8_VIDEO_SSE2
+        const __m128i rowScale = _mm_set_epi16(static_cast<short>(factor), static_cast<short>(factor),
+                                               static_cast<short>(factor), 256,
+                                               static_cast<short>(factor), static_cast<short>(factor),
+                                               static_cast<short>(factor), 256);
+        const __m128i zero = _mm_setzero_si128();
+        unsigned int x = 0;
+
+        for (; x + 4 <= areaWidth; x += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + x));
+            __m128i low = _mm_unpacklo_epi8(pixels, zero);
+            __m128i high = _mm_unpackhi_epi8(pixels, zero);
+
+            low = _mm_srli_epi16(_mm_mullo_epi16(low, rowScale), 8);
+            high = _mm_srli_epi16(_mm_mullo_epi16(high, rowScale), 8);
+            if (effect == ScaleEffect::Crt)
+            {
+                low = _mm_srli_epi16(_mm_mullo_epi16(low, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&grille[x * 4]))), 8);
+                high = _mm_srli_epi16(_mm_mullo_epi16(high, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&grille[x * 4 + 8]))), 8);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(low, high));
+        }
+#else
+        unsigned int x = 0;
+#endif
+        for (; x < areaWidth; ++x)
+        {
+            uint32_t pixel = 0;
+            for (unsigned int channel = 0; channel < 4; ++channel)
+            {
+                unsigned int value = (in[x] >> (8 * channel)) & 0xFFu;
+                value = channel == 0 ? value : (value * factor) >> 8u;
+                value = (value * grille[x * 4 + channel]) >> 8u;
+                pixel |= value << (8 * channel);
+            }
+            out[x] = pixel;
+        }
+    }
+
+    void Band(size_t band, size_t bands) const
+    {
+        const unsigned int first = static_cast<unsigned int>(destHeight * band / bands);
+        const unsigned int last = static_cast<unsigned int>(destHeight * (band + 1) / bands);
+        uint32_t const* scaled = prescale > 1 ? upscaled.data() : source;
+        const unsigned int scaledWidth = sourceWidth * prescale;
+
+        // The current source row expanded, reused while output rows keep mapping to it
+        std::vector<uint32_t> line(areaWidth);
+        unsigned int expanded = ~0u;
+
+        for (unsigned int y = first; y < last; ++y)
+        {
+            uint32_t* out = dest + y * destPitch;
+
+            if (y < areaY || y >= areaY + areaHeight)
+            {
+                std::fill(out, out + destWidth, SCALER_BORDER);
+                continue;
+            }
+            std::fill(out, out + areaX, SCALER_BORDER);
+            std::fill(out + areaX + areaWidth, out + destWidth, SCALER_BORDER);
+
+            const unsigned int areaRow = y - areaY;
+            if (rows[areaRow] != expanded)
+            {
+                expanded = rows[areaRow];
+                ExpandLine(scaled + expanded * scaledWidth, line.data());
+            }
+
+            if (effect == ScaleEffect::None)
+            {
+                memcpy(out + areaX, line.data(), areaWidth * sizeof(uint32_t));
+            }
+            else
+            {
+                ShadeLine(line.data(), out + areaX, rowFactor[areaRow]);
+            }
+        }
+    }
+
+    void WorkerLoop(size_t worker)
+    {
+        while (true)
+        {
+            start->arrive_and_wait();
+            if (stopping)
+            {
+                return;
+            }
+
+            Band(worker, workers.size() + 1);
+            finish->arrive_and_wait();
+        }
+    }
+
+public:
+    /**
+     * @param strength how dark scanlines and how strong the grille get, 0 to 1
+     * @param threads bands per frame, the calling thread does one of them
+     */
+    SoftwareScaler(ScaleFilter filter, ScaleEffect effect, float strength, unsigned int threads)
+        : filter(filter), effect(effect), strength(std::clamp(strength, 0.0f, 1.0f))
+    {
+        threads = std::max(1u, threads);
+        start = std::make_unique<std::barrier<>>(threads);
+        finish = std::make_unique<std::barrier<>>(threads);
+        for (unsigned int worker = 0; worker + 1 < threads; ++worker)
+        {
+            workers.emplace_back(&SoftwareScaler::WorkerLoop, this, worker);
+        }
+    }
+
+    ~SoftwareScaler()
+    {
+        stopping = true;
+        if (!workers.empty())
+        {
+            start->arrive_and_wait();
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    SoftwareScaler(SoftwareScaler const&) = delete;
+    SoftwareScaler& operator=(SoftwareScaler const&) = delete;
+
+    /**
+     * Scale an RGBA8888 image into an RGBA8888 buffer of any size.
+     * @param pitch output pixels from one row to the next
+     */
+    void Scale(uint32_t const* pixels, unsigned int width, unsigned int height,
+               uint32_t* out, unsigned int outWidth, unsigned int outHeight, size_t pitch)
+    {
+        if (width != sourceWidth || height != sourceHeight || outWidth != destWidth || outHeight != destHeight)
+        {
+            sourceWidth = width;
+            sourceHeight = height;
+            destWidth = outWidth;
+            destHeight = outHeight;
+            Layout();
+        }
+
+        source = pixels;
+        dest = out;
+        destPitch = pitch;
+
+        // Small enough to prescale on this thread before the bands start
+        if (prescale == 2)
+        {
+            Scale2x(pixels, width, height, upscaled.data());
+        }
+        else if (prescale == 4)
+        {
+            half.resize(static_cast<size_t>(width) * height * 4);
+            Scale2x(pixels, width, height, half.data());
+            Scale2x(half.data(), width * 2, height * 2, upscaled.data());
+        }
+
+        if (!workers.empty())
+        {
+            start->arrive_and_wait();
+        }
+        Band(workers.size(), workers.size() + 1);
+        if (!workers.empty())
+        {
+            finish->arrive_and_wait();
+        }
+    }
+};
+
+#endif //SCALER_CPP
@@ -0,0 +1,180 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef STRESS_ROM_CPP
+#define STRESS_ROM_CPP
+
+#include <cstring>
+#include <random>
+#include <string>
+#include "Chip8.h"
+
+// Instructions each mix puts in its loop body, long enough that the closing jump is noise
+constexpr unsigned int STRESS_BODY_LENGTH = 96;
+
+/**
+ * Which instructions a synthetic ROM spends its time on.
+ */
+enum class StressMix
+{
+    Draw,   // Dxyn at every height
+    Alu,    // 8xy4 and 8xy5
+    Call,   // 2nnn and 00EE, nested up to the full stack
+    Memory, // Fx55 and Fx65 at every width
+    COUNT
+};
+
+inline char const* StressMixName(StressMix mix)
+{
+    switch (mix)
+    {
+        case StressMix::Draw: return "draw";
+        case StressMix::Alu: return "alu";
+        case StressMix::Call: return "call";
+        case StressMix::Memory: return "memory";
+        case StressMix::COUNT: break;
+    }
+    return "?";
+}
+
+inline bool ParseStressMix(char const* name, StressMix& mix)
+{
+    for (unsigned int i = 0; i < static_cast<unsigned int>(StressMix::COUNT); ++i)
+    {
+        if (std::strcmp(name, StressMixName(static_cast<StressMix>(i))) == 0)
+        {
+            mix = static_cast<StressMix>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Writes assembler source for a ROM that runs one opcode mix in an endless loop,
+ * so a fixed instruction budget measures the handlers for that mix and little else.
+ * The same seed always gives the same program.
+ */
+class StressRomGenerator
+{
+    std::string source;
+    std::mt19937 random;
+
+    void Emit(std::string const& line)
+    {
+        source += "        " + line + "\n";
+    }
+
+    void Label(std::string const& name)
+    {
+        source += name + ":\n";
+    }
+
+    static std::string V(unsigned int x)
+    {
+        return std::string("V") + "0123456789ABCDEF"[x & 0xFu];
+    }
+
+    std::string Register()
+    {
+        // VF is the flag register every one of these ops overwrites
+        return V(random() % 15);
+    }
+
+    void Draw()
+    {
+        Emit("OP_00E0");
+        Label("loop");
+        for (unsigned int i = 0; i < STRESS_BODY_LENGTH / 4; ++i)
+        {
+            Emit("OP_Annn " + std::string(i % 2 ? "sprite" : "sprite_alt"));
+            // Dxy0 is the 16x16 sprite on SCHIP, a height of 16 rows otherwise
+            Emit("OP_Dxyn V0, V1, " + std::to_string(i % 16));
+            Emit("OP_7xkk V0, " + std::to_string(5 + random() % 7));
+            Emit("OP_7xkk V1, " + std::to_string(3 + random() % 5));
+        }
+        Emit("OP_1nnn loop");
+        Label("sprite");
+        Emit("db 0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xBD, 0x81, 0xFF, 0x18, 0x3C, 0x7E, 0xFF, 0x7E, 0x3C, 0x18, 0x00");
+        Emit("db 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55");
+        Label("sprite_alt");
+        Emit("db 0xF0, 0x0F, 0xF0, 0x0F, 0xC3, 0x3C, 0xC3, 0x3C, 0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81");
+        Emit("db 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01");
+    }
+
+    void Alu()
+    {
+        for (unsigned int x = 0; x < 15; ++x)
+        {
+            Emit("OP_6xkk " + V(x) + ", " + std::to_string(random() & 0xFFu));
+        }
+        Label("loop");
+        for (unsigned int i = 0; i < STRESS_BODY_LENGTH; ++i)
+        {
+            Emit(std::string(i % 2 ? "OP_8xy5 " : "OP_8xy4 ") + Register() + ", " + Register());
+        }
+        Emit("OP_1nnn loop");
+    }
+
+    void Call()
+    {
+        // Leave a slot for the loop's own call
+        constexpr unsigned int depth = STACK_SIZE - 1;
+
+        Label("loop");
+        for (unsigned int i = 0; i < STRESS_BODY_LENGTH / 2; ++i)
+        {
+            Emit("OP_2nnn level" + std::to_string(i % 2 ? depth - 1 : random() % depth));
+        }
+        Emit("OP_1nnn loop");
+
+        // Each level calls the next, so a call to level n nests depth - n deep
+        for (unsigned int level = 0; level < depth; ++level)
+        {
+            Label("level" + std::to_string(level));
+            if (level + 1 < depth)
+            {
+                Emit("OP_2nnn level" + std::to_string(level + 1));
+            }
+            Emit("OP_00EE");
+        }
+    }
+
+    void Memory()
+    {
+        Label("loop");
+        for (unsigned int i = 0; i < STRESS_BODY_LENGTH / 3; ++i)
+        {
+            // Reload I, the load/store quirk decides whether Fx55/Fx65 advance it
+            Emit("OP_Annn buffer");
+            Emit(std::string(i % 2 ? "OP_Fx65 " : "OP_Fx55 ") + V(i / 2));
+            Emit("OP_7xkk " + Register() + ", 1");
+        }
+        Emit("OP_1nnn loop");
+        Label("buffer");
+        Emit("db 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0");
+        Emit("db 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0");
+    }
+
+public:
+    explicit StressRomGenerator(unsigned int seed = 1) : random(seed) {}
+
+    std::string Generate(StressMix mix)
+    {
+        source = std::string("; Synthetic ") + StressMixName(mix) + " workload\n";
+
+        switch (mix)
+        {
+            case StressMix::Draw: Draw(); break;
+            case StressMix::Alu: Alu(); break;
+            case StressMix::Call: Call(); break;
+            case StressMix::Memory: Memory(); break;
+            case StressMix::COUNT: break;
+        }
+
+        return source;
+    }
+};
+
+#endif //STRESS_ROM_CPP
@@ -0,0 +1,316 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef TERMINAL_PLATFORM_CPP
+#define TERMINAL_PLATFORM_CPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Chip8.h"
+
+// Frames a key counts as held after its last byte, terminals only report presses and auto-repeat
+constexpr unsigned int TERMINAL_KEY_HOLD_FRAMES = 8;
+// Largest grid of cells either mode needs, half blocks of the hires display
+constexpr unsigned int TERMINAL_MAX_CELLS = HIRES_VIDEO_WIDTH * (HIRES_VIDEO_HEIGHT / 2);
+
+/**
+ * HalfBlock: a cell is two pixels stacked, drawn as an upper half block in the top pixel's
+ * colour on the bottom pixel's, all four palette colours in 24-bit colour.
+ * Braille: a cell is 2x4 pixels as Braille dots, lit or not, a quarter of the cells.
+ */
+enum class TerminalMode : uint8_t
+{
+    HalfBlock,
+    Braille
+};
+
+/**
+ * Text-mode stand-in for Platform, drawing to an ANSI terminal for sessions over SSH.
+ * Each frame only the cells that changed are written, each addressed with a cursor move
+ * unless it follows the last one written, and colours are set only when they change,
+ * so a frame is a handful of bytes and the whole frame goes out in one write.
+ * Input comes from stdin in raw mode, with the same key layout as the SDL window.
+ */
+class TerminalPlatform
+{
+    TerminalMode mode;
+    termios original{};
+    bool raw{};
+
+    uint32_t palette[4] = {0x000000FF, 0xFFFFFFFF, 0xAAAAAAFF, 0x555555FF};
+
+    // What each cell on screen shows, palette indices top << 2 | bottom or Braille dots
+    uint8_t cells[TERMINAL_MAX_CELLS]{};
+    unsigned int columns{};
+    unsigned int rows{};
+    bool redrawAll = true;
+
+    std::string frame;
+    unsigned long long bytesWritten{};
+
+    uint8_t held[16]{};
+    bool wasPlaying{};
+
+    static unsigned int Pixel(uint64_t const* video, unsigned int x, unsigned int y)
+    {
+        uint64_t const* row = video + static_cast<size_t>(y) * VIDEO_ROW_WORDS + (x >> 6u);
+        const unsigned int shift = 63u - (x & 63u);
+        return ((row[0] >> shift) & 1u) | (((row[VIDEO_PLANE_WORDS] >> shift) & 1u) << 1u);
+    }
+
+    void Color(char const* prefix, uint32_t color)
+    {
+        frame += prefix;
+        frame += std::to_string(color >> 24u) + ';' + std::to_string((color >> 16u) & 0xFFu) + ';' +
+                 std::to_string((color >> 8u) & 0xFFu) + 'm';
+    }
+
+    /**
+     * UTF-8 of U+2800 + dots, always three bytes.
+     */
+    void Braille(uint8_t dots)
+    {
+        const unsigned int code = 0x2800u + dots;
+        frame += static_cast<char>(0xE0u | (code >> 12u));
+        frame += static_cast<char>(0x80u | ((code >> 6u) & 0x3Fu));
+        frame += static_cast<char>(0x80u | (code & 0x3Fu));
+    }
+
+    void Write()
+    {
+        size_t written = 0;
+        while (written < frame.size())
+        {
+            const ssize_t result = ::write(STDOUT_FILENO, frame.data() + written, frame.size() - written);
+            if (result <= 0)
+            {
+                break;
+            }
+            written += static_cast<size_t>(result);
+        }
+        bytesWritten += written;
+        frame.clear();
+    }
+
+public:
+    explicit TerminalPlatform(char const* title, TerminalMode mode = TerminalMode::HalfBlock) : mode(mode)
+    {
+        // No echo, no line buffering, Ctrl+C arrives as a byte and quits like Escape
+        if (tcgetattr(STDIN_FILENO, &original) == 0)
+        {
+            termios settings = original;
+            settings.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO | ISIG | IEXTEN);
+            settings.c_iflag &= ~static_cast<tcflag_t>(IXON | ICRNL);
+            settings.c_cc[VMIN] = 0;
+            settings.c_cc[VTIME] = 0;
+            raw = tcsetattr(STDIN_FILENO, TCSAFLUSH, &settings) == 0;
+        }
+
+        // Title, alternate screen, no cursor
+        frame = std::string("\x1b]0;") + title + "\x07\x1b[?1049h\x1b[?25l\x1b[2J";
+        Write();
+    }
+
+    ~TerminalPlatform()
+    {
+        frame = "\x1b[0m\x1b[?25h\x1b[?1049l";
+        Write();
+
+        if (raw)
+        {
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &original);
+        }
+    }
+
+    TerminalPlatform(TerminalPlatform const&) = delete;
+    TerminalPlatform& operator=(TerminalPlatform const&) = delete;
+
+    /**
+     * Same meaning as Platform::SetPalette. Braille draws in the second colour on the first.
+     */
+    void SetPalette(uint32_t const* colors, int count)
+    {
+        palette[0] = colors[0];
+        palette[1] = colors[1];
+        palette[2] = count >= 4 ? colors[2] : colors[1];
+        palette[3] = count >= 4 ? colors[3] : colors[1];
+        redrawAll = true;
+    }
+
+    /**
+     * Same arguments as Platform::Update, writes the cells that differ from the last frame.
+     */
+    void Update(uint64_t const* video, int width, int height)
+    {
+        const unsigned int cellWidth = mode == TerminalMode::Braille ? 2 : 1;
+        const unsigned int cellHeight = mode == TerminalMode::Braille ? 4 : 2;
+        const unsigned int newColumns = static_cast<unsigned int>(width) / cellWidth;
+        const unsigned int newRows = static_cast<unsigned int>(height) / cellHeight;
+
+        if (newColumns != columns || newRows != rows)
+        {
+            columns = newColumns;
+            rows = newRows;
+            redrawAll = true;
+        }
+
+        if (redrawAll)
+        {
+            frame += "\x1b[0m\x1b[2J";
+            if (mode == TerminalMode::Braille)
+            {
+                Color("\x1b[38;2;", palette[1]);
+                Color("\x1b[48;2;", palette[0]);
+            }
+        }
+
+        // Where the cursor is and which colours are set, so neither is sent again needlessly
+        unsigned int cursor = ~0u;
+        // No palette index is 4, the first cell always sets both
+        unsigned int foreground = 4;
+        unsigned int background = 4;
+
+        for (unsigned int row = 0; row < rows; ++row)
+        {
+            for (unsigned int column = 0; column < columns; ++column)
+            {
+                const unsigned int x = column * cellWidth;
+                const unsigned int y = row * cellHeight;
+                uint8_t cell;
+
+                if (mode == TerminalMode::Braille)
+                {
+                    // Dots 1-2-3 down the left column, 4-5-6 down the right, then 7 and 8 below
+                    static constexpr uint8_t dot[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+                    cell = 0;
+                    for (unsigned int dy = 0; dy < 4; ++dy)
+                    {
+                        for (unsigned int dx = 0; dx < 2; ++dx)
+                        {
+                            cell |= Pixel(video, x + dx, y + dy) ? dot[dy][dx] : 0;
+                        }
+                    }
+                }
+                else
+                {
+                    cell = static_cast<uint8_t>(Pixel(video, x, y) << 2u | Pixel(video, x, y + 1));
+                }
+
+                const unsigned int index = row * columns + column;
+                if (cells[index] == cell && !redrawAll)
+                {
+                    continue;
+                }
+                cells[index] = cell;
+
+                if (cursor != index)
+                {
+                    frame += "\x1b[" + std::to_string(row + 1) + ';' + std::to_string(column + 1) + 'H';
+                }
+                // Past the last column the cursor does not wrap to the next row
+                cursor = column + 1 < columns ? index + 1 : ~0u;
+
+                if (mode == TerminalMode::Braille)
+                {
+                    Braille(cell);
+                    continue;
+                }
+
+                if (foreground != cell >> 2u)
+                {
+                    foreground = cell >> 2u;
+                    Color("\x1b[38;2;", palette[foreground]);
+                }
+                if (background != (cell & 3u))
+                {
+                    background = cell & 3u;
+                    Color("\x1b[48;2;", palette[background]);
+                }
+                frame += "\xE2\x96\x80";
+            }
+        }
+
+        redrawAll = false;
+        if (!frame.empty())
+        {
+            Write();
+        }
+    }
+
+    /**
+     * Rings the terminal bell as the sound starts, the pattern and pitch have nowhere to go.
+     */
+    void UpdateAudio(uint8_t const*, uint8_t, bool playing)
+    {
+        if (playing && !wasPlaying)
+        {
+            frame += '\a';
+            Write();
+        }
+        wasPlaying = playing;
+    }
+
+    /**
+     * Read what has been typed since the last frame into the keypad.
+     * A key stays down for TERMINAL_KEY_HOLD_FRAMES after its last press or auto-repeat.
+     * @return true on Escape or Ctrl+C
+     */
+    bool ProcessInput(uint8_t* keys)
+    {
+        // Same layout as the SDL window, 1234 / QWER / ASDF / ZXCV
+        static constexpr char layout[17] = "x123qweasdzc4rfv";
+
+        for (unsigned int key = 0; key < 16; ++key)
+        {
+            held[key] -= held[key] > 0;
+        }
+
+        bool quit = false;
+        char input[64];
+        ssize_t count;
+        // Polled first, stdin may be a pipe rather than a raw terminal and would block
+        pollfd ready{STDIN_FILENO, POLLIN, 0};
+        while (poll(&ready, 1, 0) > 0 && (count = ::read(STDIN_FILENO, input, sizeof(input))) > 0)
+        {
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                // A lone Escape quits, one starting a sequence (arrow keys and such) is skipped
+                if (input[i] == '\x1b')
+                {
+                    quit |= i + 1 == count;
+                    i = count;
+                    continue;
+                }
+                quit |= input[i] == '\x03';
+
+                char const* key = std::strchr(layout, input[i] | 0x20);
+                if (key && *key)
+                {
+                    held[key - layout] = TERMINAL_KEY_HOLD_FRAMES;
+                }
+            }
+        }
+
+        for (unsigned int key = 0; key < 16; ++key)
+        {
+            keys[key] = held[key] > 0;
+        }
+
+        return quit;
+    }
+
+    /**
+     * Everything written to the terminal so far, escape sequences included.
+     */
+    [[nodiscard]] unsigned long long BytesWritten() const
+    {
+        return bytesWritten;
+    }
+};
+
+#endif //TERMINAL_PLATFORM_CPP
@@ -0,0 +1,150 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <cstdint>
+#include "Opcodes.h"
+
+/**
+ * How long a frame is.
+ * Instructions: a fixed instruction count, every opcode costing the same (the original behaviour).
+ * VipTable: COSMAC VIP machine cycles per opcode from a table.
+ * VipAccurate: the table plus the operand-dependent parts, sprite rows and alignment,
+ * BCD digit loops, registers copied by Fx55/Fx65 and taken skips.
+ */
+enum class TimingMode : uint8_t
+{
+    Instructions,
+    VipTable,
+    VipAccurate
+};
+
+// 1.76 MHz 1802, 8 clocks per machine cycle, 60 Hz frames
+constexpr unsigned int VIP_FRAME_CYCLES = 3668;
+// Lost every frame to the display DMA (128 bytes four times over) and the interrupt routine
+constexpr unsigned int VIP_DISPLAY_CYCLES = 1024 + 46;
+// What is left for the interpreter
+constexpr unsigned int VIP_PROGRAM_CYCLES = VIP_FRAME_CYCLES - VIP_DISPLAY_CYCLES;
+// Fetching and dispatching an instruction, paid by every opcode
+constexpr unsigned int VIP_DISPATCH_CYCLES = 40;
+// Upper bound on instructions per frame, what a scheduler can plan a timed frame around
+constexpr unsigned int VIP_MAX_INSTRUCTIONS_PER_FRAME = VIP_PROGRAM_CYCLES / (VIP_DISPATCH_CYCLES + 6) + 1;
+
+/**
+ * Machine cycles an instruction takes on the VIP interpreter, dispatch included, for the
+ * common case: one-row sprites on a byte boundary, skips not taken, Fx55/Fx65 of V0 alone.
+ * Rounded from published timings of the original interpreter. SCHIP and XO-CHIP opcodes
+ * never ran there and get a flat cost in line with their nearest VIP relative.
+ */
+constexpr unsigned int OpCycles(Op op)
+{
+    switch (op)
+    {
+        case Op::OP_00E0: return VIP_DISPATCH_CYCLES + 640;
+        case Op::OP_00EE: return VIP_DISPATCH_CYCLES + 10;
+        case Op::OP_1nnn: return VIP_DISPATCH_CYCLES + 12;
+        case Op::OP_2nnn: return VIP_DISPATCH_CYCLES + 26;
+        case Op::OP_3xkk:
+        case Op::OP_4xkk: return VIP_DISPATCH_CYCLES + 10;
+        case Op::OP_5xy0:
+        case Op::OP_9xy0: return VIP_DISPATCH_CYCLES + 14;
+        case Op::OP_6xkk: return VIP_DISPATCH_CYCLES + 6;
+        case Op::OP_7xkk: return VIP_DISPATCH_CYCLES + 10;
+        case Op::OP_8xy0:
+        case Op::OP_8xy1:
+        case Op::OP_8xy2:
+        case Op::OP_8xy3:
+        case Op::OP_8xy4:
+        case Op::OP_8xy5:
+        case Op::OP_8xy6:
+        case Op::OP_8xy7:
+        case Op::OP_8xyE: return VIP_DISPATCH_CYCLES + 44;
+        case Op::OP_Annn: return VIP_DISPATCH_CYCLES + 12;
+        case Op::OP_Bnnn: return VIP_DISPATCH_CYCLES + 22;
+        case Op::OP_Cxkk: return VIP_DISPATCH_CYCLES + 36;
+        case Op::OP_Dxyn: return VIP_DISPATCH_CYCLES + 26 + 28;
+        case Op::OP_Ex9E:
+        case Op::OP_ExA1: return VIP_DISPATCH_CYCLES + 14;
+        case Op::OP_Fx07:
+        case Op::OP_Fx15:
+        case Op::OP_Fx18: return VIP_DISPATCH_CYCLES + 10;
+        case Op::OP_Fx0A: return VIP_DISPATCH_CYCLES + 20;
+        case Op::OP_Fx1E: return VIP_DISPATCH_CYCLES + 16;
+        case Op::OP_Fx29: return VIP_DISPATCH_CYCLES + 20;
+        case Op::OP_Fx33: return VIP_DISPATCH_CYCLES + 84;
+        case Op::OP_Fx55:
+        case Op::OP_Fx65: return VIP_DISPATCH_CYCLES + 14 + 14;
+
+        case Op::OP_00Cn:
+        case Op::OP_00Dn:
+        case Op::OP_00FB:
+        case Op::OP_00FC:
+        case Op::OP_00FE:
+        case Op::OP_00FF: return VIP_DISPATCH_CYCLES + 640;
+        case Op::OP_00FD:
+        case Op::OP_5xy2:
+        case Op::OP_5xy3:
+        case Op::OP_F000:
+        case Op::OP_Fn01:
+        case Op::OP_F002:
+        case Op::OP_Fx30:
+        case Op::OP_Fx3A:
+        case Op::OP_Fx75:
+        case Op::OP_Fx85: return VIP_DISPATCH_CYCLES + 20;
+
+        case Op::OP_NULL:
+        case Op::TABLE0:
+        case Op::TABLE5:
+        case Op::TABLE8:
+        case Op::TABLEE:
+        case Op::TABLEF:
+        case Op::COUNT: break;
+    }
+    return VIP_DISPATCH_CYCLES;
+}
+
+/**
+ * OpCycles plus what depends on the operands, given the registers before the instruction ran.
+ * A sprite row costs more when the sprite straddles two display bytes, the BCD conversion
+ * counts down each digit, and a taken skip fetches past the skipped word.
+ */
+constexpr unsigned int OpCyclesAccurate(Op op, uint16_t opcode, uint8_t const* registers, bool skipped)
+{
+    const unsigned int x = (opcode & 0x0F00u) >> 8u;
+    const unsigned int y = (opcode & 0x00F0u) >> 4u;
+    unsigned int cycles = OpCycles(op) + (skipped ? 4 : 0);
+
+    switch (op)
+    {
+        case Op::OP_Dxyn:
+        {
+            // Dxy0 is 16 rows
+            const unsigned int rows = (opcode & 0x000Fu) ? opcode & 0x000Fu : 16;
+            const unsigned int perRow = registers[x] % 8 ? 46 : 28;
+            // The table charged one aligned row
+            cycles += rows * perRow - 28;
+            // Rows past the bottom are clipped before any work
+            if (registers[y] % 32 + rows > 32)
+            {
+                cycles -= (registers[y] % 32 + rows - 32) * perRow;
+            }
+            break;
+        }
+        case Op::OP_Fx33:
+        {
+            const unsigned int value = registers[x];
+            cycles += 16 * (value / 100 + value / 10 % 10 + value % 10);
+            break;
+        }
+        case Op::OP_Fx55:
+        case Op::OP_Fx65: cycles += 14 * x; break;
+        default: break;
+    }
+
+    return cycles;
+}
+
+#endif //TIMING_H
@@ -0,0 +1,232 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef VALIDATOR_CPP
+#define VALIDATOR_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include "Disassembler.cpp"
+#include "Engine.cpp"
+
+// Instructions shown either side of a divergence
+constexpr unsigned int VALIDATOR_WINDOW = 6;
+
+struct Divergence
+{
+    // Instructions run before the states first differed, counting the one that broke them
+    uint64_t instruction{};
+    // Where that instruction was, in the reference run
+    uint16_t pc{};
+    // The first field that differs, reference value first
+    std::string difference;
+    // Disassembly around pc
+    std::string window;
+};
+
+/**
+ * Runs two engines side by side on the same ROM and inputs and compares the full
+ * machine state every interval instructions. On a mismatch both go back to the last
+ * matching state and are re-run with growing budgets until the first instruction
+ * (or, for block engines, the first block) where they part ways.
+ */
+class LockstepValidator
+{
+    ExecutionEngine& reference;
+    ExecutionEngine& candidate;
+    unsigned int interval;
+
+    static std::string Hex(unsigned int value)
+    {
+        char text[16];
+        std::snprintf(text, sizeof(text), "%X", value);
+        return text;
+    }
+
+    /**
+     * @return an empty string if the states match, otherwise the first difference
+     */
+    static std::string Compare(Chip8 const& a, Chip8 const& b)
+    {
+        auto field = [](char const* name, unsigned int x, unsigned int y) {
+            return x == y ? std::string() : std::string(name) + ": " + Hex(x) + " vs " + Hex(y);
+        };
+
+        std::string difference;
+        auto check = [&](std::string const& result) {
+            if (difference.empty())
+            {
+                difference = result;
+            }
+        };
+
+        check(field("pc", a.pc, b.pc));
+        check(field("I", a.index, b.index));
+        check(field("sp", a.sp, b.sp));
+        check(field("opcode", a.opcode, b.opcode));
+        check(field("delay timer", a.delayTimer, b.delayTimer));
+        check(field("sound timer", a.soundTimer, b.soundTimer));
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            check(field(("V" + Hex(i)).c_str(), a.registers[i], b.registers[i]));
+        }
+        for (unsigned int i = 0; i < STACK_SIZE; ++i)
+        {
+            check(field(("stack[" + Hex(i) + "]").c_str(), a.stack[i], b.stack[i]));
+        }
+        for (unsigned int i = 0; i < FLAG_REGISTER_COUNT; ++i)
+        {
+            check(field(("flag " + Hex(i)).c_str(), a.flags[i], b.flags[i]));
+        }
+        check(field("hires", a.hires, b.hires));
+        check(field("exited", a.exited, b.exited));
+        check(field("planes", a.planes, b.planes));
+        check(field("pitch", a.pitch, b.pitch));
+        check(field("cycle balance", static_cast<unsigned int>(a.cycleBalance), static_cast<unsigned int>(b.cycleBalance)));
+        check(field("display wait", a.displayWait, b.displayWait));
+        check(field("vblank", a.vblank, b.vblank));
+        check(field("waiting for vblank", a.waitingForVblank, b.waitingForVblank));
+        check(memcmp(a.audioPattern, b.audioPattern, AUDIO_PATTERN_SIZE) ? "audio pattern" : "");
+        check(a.randGen == b.randGen ? "" : "random generator");
+
+        for (unsigned int page = 0; page < MEMORY_SIZE / PAGE_SIZE && difference.empty(); ++page)
+        {
+            if (a.memory.SharesPage(b.memory, page))
+            {
+                continue;
+            }
+            for (unsigned int address = page * PAGE_SIZE; address < (page + 1) * PAGE_SIZE; ++address)
+            {
+                if (a.memory[address] != b.memory[address])
+                {
+                    check(field(("memory[" + Hex(address) + "]").c_str(), a.memory[address], b.memory[address]));
+                    break;
+                }
+            }
+        }
+
+        for (unsigned int row = 0; row < HIRES_VIDEO_HEIGHT && difference.empty(); ++row)
+        {
+            for (unsigned int plane = 0; plane < VIDEO_PLANES; ++plane)
+            {
+                if (memcmp(a.video[plane][row], b.video[plane][row], sizeof(a.video[plane][row])) != 0)
+                {
+                    check("display row " + std::to_string(row) + " plane " + std::to_string(plane));
+                }
+            }
+        }
+        check(a.frameHash == b.frameHash ? "" : "frame hash");
+
+        return difference;
+    }
+
+    static std::string Window(Chip8 const& chip8, uint16_t pc)
+    {
+        static const Disassembler disassembler;
+        std::string window;
+        char line[16];
+
+        auto word = [&](unsigned int address) -> uint16_t {
+            return (chip8.memory[address & MEMORY_MASK] << 8u) | chip8.memory[(address + 1) & MEMORY_MASK];
+        };
+
+        for (int i = -static_cast<int>(VALIDATOR_WINDOW); i <= static_cast<int>(VALIDATOR_WINDOW); ++i)
+        {
+            const unsigned int address = (pc + 2 * i) & MEMORY_MASK;
+            const uint16_t opcode = word(address);
+
+            std::snprintf(line, sizeof(line), "%s %03X  %04X  ", i == 0 ? ">" : " ", address, opcode);
+            window += line;
+            window += disassembler.Instruction(opcode, word(address + 2));
+            window += '\n';
+        }
+
+        return window;
+    }
+
+    /**
+     * Narrow a mismatch down from the last state both engines agreed on.
+     */
+    Divergence Bisect(Chip8State const& good, uint64_t base, unsigned int limit)
+    {
+        Chip8 a;
+        Chip8 b;
+
+        for (unsigned int budget = 1;; ++budget)
+        {
+            a.LoadState(good);
+            b.LoadState(good);
+
+            reference.Run(a, budget - 1);
+            const uint16_t pc = a.pc;
+            reference.Run(a, 1);
+            candidate.Run(b, budget);
+
+            if (std::string difference = Compare(a, b); !difference.empty() || budget == limit)
+            {
+                return Divergence{base + budget, pc, difference, Window(a, pc)};
+            }
+        }
+    }
+
+public:
+    LockstepValidator(ExecutionEngine& reference, ExecutionEngine& candidate, unsigned int interval)
+        : reference(reference), candidate(candidate), interval(interval ? interval : 1)
+    {}
+
+    /**
+     * Boot the ROM once, give both engines the same copy and run them for a number of frames.
+     * Keys are pressed on a fixed schedule so input handling is exercised too.
+     * @param displayWait run with the display-wait quirk, stalled Dxyn released at every frame's vblank
+     * @return the first divergence, or nothing if the engines agreed throughout
+     */
+    std::optional<Divergence> Validate(uint8_t const* rom, size_t size, unsigned long frames, unsigned int cyclesPerFrame,
+                                       bool displayWait = false)
+    {
+        Chip8 a;
+        a.LoadROM(rom, size);
+        a.displayWait = displayWait;
+        Chip8 b;
+        b.LoadState(a);
+
+        Chip8State good;
+        uint64_t executed = 0;
+
+        for (unsigned long frame = 0; frame < frames; ++frame)
+        {
+            const unsigned int key = (frame >> 3u) & 0xFu;
+            for (unsigned int i = 0; i < 16; ++i)
+            {
+                a.keypad[i] = b.keypad[i] = i == key && (frame & 4u);
+            }
+
+            for (unsigned int done = 0; done < cyclesPerFrame;)
+            {
+                const unsigned int chunk = std::min(interval, cyclesPerFrame - done);
+                a.SaveState(good);
+                reference.Run(a, chunk);
+                candidate.Run(b, chunk);
+
+                if (!Compare(a, b).empty())
+                {
+                    return Bisect(good, executed, chunk);
+                }
+
+                executed += chunk;
+                done += chunk;
+            }
+
+            a.Vblank();
+            b.Vblank();
+        }
+
+        return std::nullopt;
+    }
+};
+
+#endif //VALIDATOR_CPP
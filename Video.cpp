@@ -0,0 +1,67 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#ifndef VIDEO_CPP
+#define VIDEO_CPP
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHIP8_VIDEO_SSE2
+#endif
+
+/**
+ * Expand one packed display row of two bitplanes into RGBA.
+ * Each pixel becomes palette[plane0 bit | plane1 bit << 1].
+ * The SSE2 path does four pixels per step with masks instead of a lookup,
+ * width must be a multiple of 4 (64 and 128 both are).
+ * @param plane0 row of the first plane, leftmost pixel in the MSB of the first word
+ * @param plane1 same row of the second plane
+ * @param width pixels in the row
+ * @param palette four RGBA colours
+ * @param out width RGBA pixels
+ */
+inline void ExpandRow(uint64_t const* plane0, uint64_t const* plane1, unsigned int width,
+                      uint32_t const* palette, uint32_t* out)
+{
+#ifdef CHIP8_VIDEO_SSE2
+    // Lane 0 is the leftmost pixel, which is the highest bit of each nibble
+    const __m128i bitSelect = _mm_set_epi32(1, 2, 4, 8);
+    const __m128i color0 = _mm_set1_epi32(static_cast<int>(palette[0]));
+    const __m128i color1 = _mm_set1_epi32(static_cast<int>(palette[1]));
+    const __m128i color2 = _mm_set1_epi32(static_cast<int>(palette[2]));
+    const __m128i color3 = _mm_set1_epi32(static_cast<int>(palette[3]));
+
+    for (unsigned int x = 0; x < width; x += 4)
+    {
+        const unsigned int word = x >> 6u;
+        const unsigned int shift = 60u - (x & 63u);
+
+        const auto nibble0 = static_cast<int>((plane0[word] >> shift) & 0xFu);
+        const auto nibble1 = static_cast<int>((plane1[word] >> shift) & 0xFu);
+
+        // All ones in every lane whose pixel is set
+        const __m128i mask0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(nibble0), bitSelect), bitSelect);
+        const __m128i mask1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(nibble1), bitSelect), bitSelect);
+
+        const __m128i low = _mm_or_si128(_mm_and_si128(mask0, color1), _mm_andnot_si128(mask0, color0));
+        const __m128i high = _mm_or_si128(_mm_and_si128(mask0, color3), _mm_andnot_si128(mask0, color2));
+        const __m128i color = _mm_or_si128(_mm_and_si128(mask1, high), _mm_andnot_si128(mask1, low));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), color);
+    }
+#else
+    for (unsigned int x = 0; x < width; ++x)
+    {
+        const unsigned int word = x >> 6u;
+        const unsigned int shift = 63u - (x & 63u);
+        const unsigned int color = ((plane0[word] >> shift) & 1u) | (((plane1[word] >> shift) & 1u) << 1u);
+
+        out[x] = palette[color];
+    }
+#endif
+}
+
+#endif //VIDEO_CPP
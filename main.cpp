@@ -1,48 +1,315 @@
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "Chip8.cpp"
+#include "Compositor.cpp"
 #include "Platform.cpp"
+#include "Playlist.cpp"
+#include "Profiler.cpp"
+#include "RomLibrary.cpp"
+#include "RomWatcher.cpp"
+
+constexpr float FRAME_TIME = 1000.0f / 60.0f;
+// Cycles per frame when no delay is given
+constexpr unsigned int MAX_CYCLES_PER_FRAME = 1000;
 
 int main(int argc, char *argv[])
 {
-    if (argc != 4)
+    // Options may go anywhere, everything else is positional
+    std::vector<char*> positional{argv[0]};
+    CompositeMode composite = CompositeMode::Off;
+    float compositeAmount = 0.0f;
+    bool softwareScale = false;
+    bool watch = false;
+    // Dxyn waits for the vblank with any timing, the vip timings always do
+    bool displayWait = false;
+    // Seconds each ROM of a playlist plays for, 0 until Tab, negative for no playlist
+    int playlistSeconds = -1;
+    ScaleFilter scaleFilter = ScaleFilter::Nearest;
+    ScaleEffect scaleEffect = ScaleEffect::None;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--composite") == 0 && i + 1 < argc)
+        {
+            // or[:frames] or phosphor[:persistence]
+            std::string value = argv[++i];
+            const size_t colon = value.find(':');
+            if (colon != std::string::npos)
+            {
+                compositeAmount = std::stof(value.substr(colon + 1));
+                value.resize(colon);
+            }
+            composite = value == "or" ? CompositeMode::Or : value == "phosphor" ? CompositeMode::Phosphor : CompositeMode::Off;
+        }
+        else if (std::strcmp(argv[i], "--scaler") == 0 && i + 1 < argc)
+        {
+            // nearest, integer or pixelart, then +scanlines or +crt
+            std::string value = argv[++i];
+            const size_t plus = value.find('+');
+            if (plus != std::string::npos)
+            {
+                const std::string effect = value.substr(plus + 1);
+                scaleEffect = effect == "scanlines" ? ScaleEffect::Scanlines : effect == "crt" ? ScaleEffect::Crt : ScaleEffect::None;
+                value.resize(plus);
+            }
+            scaleFilter = value == "integer" ? ScaleFilter::Integer : value == "pixelart" ? ScaleFilter::PixelArt : ScaleFilter::Nearest;
+            softwareScale = true;
+        }
+        else if (std::strcmp(argv[i], "--playlist") == 0 && i + 1 < argc)
+        {
+            playlistSeconds = std::max(0, std::stoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--watch") == 0)
+        {
+            watch = true;
+        }
+        else if (std::strcmp(argv[i], "--display-wait") == 0)
+        {
+            displayWait = true;
+        }
+        else
+        {
+            positional.push_back(argv[i]);
+        }
+    }
+    argc = static_cast<int>(positional.size());
+    argv = positional.data();
+
+    if (argc < 4 || argc > 6)
     {
-        std::cerr << "Usage: " << argv[0] << " <Scale> <Delay> <ROM>\n";
+        std::cerr << "Usage: " << argv[0] << " [--composite or[:frames]|phosphor[:persistence]]"
+                  << " [--scaler nearest|integer|pixelart[+scanlines|+crt]] [--watch] [--playlist seconds] [--display-wait]"
+                  << " <Scale> <Delay|vip|vip-accurate> <ROM> [RunAhead] [Profile.folded]\n";
         std::exit(EXIT_FAILURE);
     }
 
-    const int videoScale = std::stoi(argv[1]);
-    const int cycleDelay = std::stoi(argv[2]);
+    int videoScale = std::stoi(argv[1]);
+    // vip times frames in COSMAC VIP machine cycles per opcode instead of a fixed delay
+    const TimingMode timing = std::strcmp(argv[2], "vip") == 0 ? TimingMode::VipTable
+                            : std::strcmp(argv[2], "vip-accurate") == 0 ? TimingMode::VipAccurate
+                            : TimingMode::Instructions;
+    int cycleDelay = timing == TimingMode::Instructions ? std::stoi(argv[2]) : 0;
     char const* romFilename = argv[3];
+    const int runAhead = argc >= 5 ? std::stoi(argv[4]) : 0;
+    char const* profileFilename = argc == 6 ? argv[5] : nullptr;
+
+    // Known ROMs get their title and saved settings from the library index
+    RomLibrary library;
+    library.Load(ROM_INDEX_FILE);
+
+    // With a playlist the ROM argument may also be a folder or a list of ROMs
+    RomPlaylist playlist(library);
+    PreparedRom current;
 
-    Platform platform("CHIP-8 Emulator",
+    if (playlistSeconds >= 0)
+    {
+        if (!playlist.Add(romFilename) || !playlist.Next(current))
+        {
+            std::cerr << "No playable ROMs in " << romFilename << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        current = RomPlaylist::Prepare(romFilename, library);
+        if (!current.loaded)
+        {
+            std::cerr << "Could not open " << romFilename << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    auto windowTitle = [](PreparedRom const& rom) { return "CHIP-8 Emulator - " + rom.title; };
+
+    if (videoScale == 0)
+    {
+        videoScale = static_cast<int>(current.settings.videoScale);
+    }
+
+    if (videoScale <= 0)
+    {
+        videoScale = 10;
+    }
+
+    Platform platform(windowTitle(current).c_str(),
         static_cast<int>(VIDEO_WIDTH) * videoScale,
         static_cast<int>(VIDEO_HEIGHT) * videoScale,
         VIDEO_WIDTH,
         VIDEO_HEIGHT);
 
     Chip8 chip8;
-    chip8.LoadROM(romFilename);
+    unsigned int cyclesPerFrame = 0;
+
+    // Switching ROM is one state copy, the window, audio and everything else stay as they are
+    auto play = [&](PreparedRom const& rom) {
+        chip8.LoadState(rom.boot);
+        // The VIP drew only on the display interrupt, so each presented frame holds whole draws
+        chip8.displayWait = displayWait || timing != TimingMode::Instructions;
+
+        // The delay is per cycle, so a frame runs as many cycles as fit in 1/60 s
+        const int delay = cycleDelay == 0 && timing == TimingMode::Instructions
+            ? static_cast<int>(rom.settings.cycleDelay) : cycleDelay;
+        cyclesPerFrame = delay > 0
+            ? std::max(1u, static_cast<unsigned int>(FRAME_TIME / static_cast<float>(delay)))
+            : MAX_CYCLES_PER_FRAME;
+    };
+    play(current);
+
+    // Run-ahead presents the frame N frames in the future, then rolls back,
+    // which hides the game's own input lag
+    Chip8State snapshot;
 
-    constexpr int videoPitch = sizeof(chip8.video[0]) * VIDEO_WIDTH;
+    // Flicker reduction between the core and the window, defaults of 2 frames or half persistence
+    FrameCompositor compositor(composite,
+        compositeAmount > 0.0f ? static_cast<unsigned int>(compositeAmount) : 2,
+        compositeAmount > 0.0f ? compositeAmount : 0.5f);
+
+    // Scaling on the CPU, one band per hardware thread
+    SoftwareScaler scaler(scaleFilter, scaleEffect, 0.5f, softwareScale ? std::thread::hardware_concurrency() : 1);
+    uint32_t expanded[HIRES_VIDEO_HEIGHT * HIRES_VIDEO_WIDTH];
+
+    // Only the frames actually played are profiled, not the ones run ahead and rolled back
+    Profiler profiler;
+
+    auto runFrame = [&]() {
+        if (timing == TimingMode::Instructions)
+        {
+            chip8.RunFrame(cyclesPerFrame);
+        }
+        else
+        {
+            chip8.RunTimedFrame(timing);
+        }
+    };
 
-    auto lastCycleTime = std::chrono::high_resolution_clock::now();
+    // Reload the ROM in place whenever it is rebuilt, the window and audio stay up.
+    // In a playlist the ROM playing is watched, not the folder or list it came from
+    std::unique_ptr<RomWatcher> watcher = watch ? std::make_unique<RomWatcher>(current.path.c_str()) : nullptr;
+
+    auto lastFrameTime = std::chrono::high_resolution_clock::now();
     bool quit = false;
+    unsigned long framesPlayed = 0;
 
-    while (!quit)
+    // A playlist only ends on Escape, a ROM exiting with 00FD moves it on like Tab
+    while (!quit && (playlistSeconds >= 0 || !chip8.exited))
     {
         quit = platform.ProcessInput(chip8.keypad);
 
         auto currentTime = std::chrono::high_resolution_clock::now();
-        float dt = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastCycleTime).count();
+        float dt = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastFrameTime).count();
 
-        if (dt > static_cast<float>(cycleDelay))
+        if (dt > FRAME_TIME)
         {
-            lastCycleTime = currentTime;
+            lastFrameTime = currentTime;
+
+            // Attract mode moves on after its time is up or on Tab, the next ROM is ready by then
+            const bool skip = platform.SkipRequested() || chip8.exited;
+            if (playlistSeconds >= 0 &&
+                (skip || (playlistSeconds > 0 && framesPlayed >= static_cast<unsigned long>(playlistSeconds) * 60)))
+            {
+                if (playlist.Next(current))
+                {
+                    play(current);
+                    platform.SetTitle(windowTitle(current).c_str());
+
+                    if (watcher)
+                    {
+                        watcher = std::make_unique<RomWatcher>(current.path.c_str());
+                    }
+                }
+                // Nothing left to move on to
+                quit |= chip8.exited;
+                framesPlayed = 0;
+            }
+            ++framesPlayed;
+
+            if (watcher && watcher->Changed())
+            {
+                // The rebuilt ROM no longer matches its library entry, so its title and settings are kept
+                if (const PreparedRom reloaded = RomPlaylist::Prepare(current.path, library); reloaded.loaded)
+                {
+                    current.boot = reloaded.boot;
+                    play(current);
+                }
+            }
+
+            if (profileFilename && timing != TimingMode::Instructions)
+            {
+                profiler.RunTimedFrame(chip8, timing);
+            }
+            else if (profileFilename)
+            {
+                profiler.RunFrame(chip8, cyclesPerFrame);
+            }
+            else
+            {
+                runFrame();
+            }
+            platform.UpdateAudio(chip8.audioPattern, chip8.pitch, chip8.soundTimer > 0);
+
+            if (runAhead > 0)
+            {
+                chip8.SaveState(snapshot);
+
+                for (int i = 0; i < runAhead; ++i)
+                {
+                    runFrame();
+                }
+            }
 
-            chip8.Cycle();
+            if (softwareScale)
+            {
+                const auto width = static_cast<int>(chip8.VideoWidth());
+                const auto height = static_cast<int>(chip8.VideoHeight());
+                uint32_t const* pixels = expanded;
 
-            platform.Update(chip8.video, videoPitch);
+                if (compositor.Mode() == CompositeMode::Phosphor)
+                {
+                    pixels = compositor.Blend(&chip8.video[0][0][0], width, height);
+                }
+                else
+                {
+                    platform.Expand(compositor.Mode() == CompositeMode::Or
+                        ? compositor.Combine(&chip8.video[0][0][0], width, height) : &chip8.video[0][0][0],
+                        width, height, expanded);
+                }
+                platform.PresentScaled(scaler, pixels, width, height);
+            }
+            else if (compositor.Mode() == CompositeMode::Or)
+            {
+                platform.Update(compositor.Combine(&chip8.video[0][0][0], chip8.VideoWidth(), chip8.VideoHeight()),
+                    static_cast<int>(chip8.VideoWidth()), static_cast<int>(chip8.VideoHeight()));
+            }
+            else if (compositor.Mode() == CompositeMode::Phosphor)
+            {
+                platform.Present(compositor.Blend(&chip8.video[0][0][0], chip8.VideoWidth(), chip8.VideoHeight()),
+                    static_cast<int>(chip8.VideoWidth()), static_cast<int>(chip8.VideoHeight()));
+            }
+            else
+            {
+                platform.Update(&chip8.video[0][0][0],
+                    static_cast<int>(chip8.VideoWidth()), static_cast<int>(chip8.VideoHeight()));
+            }
+
+            if (runAhead > 0)
+            {
+                chip8.LoadState(snapshot);
+            }
+        }
+    }
+
+    if (profileFilename)
+    {
+        profiler.PrintSummary(stdout);
+
+        if (!profiler.WriteFolded(profileFilename))
+        {
+            std::cerr << "Could not write " << profileFilename << "\n";
         }
     }
 
@@ -0,0 +1,113 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../MappedFile.cpp"
+#include "../Validator.cpp"
+
+/**
+ * Print the outcome for one ROM.
+ * @return true if the engines agreed
+ */
+bool Report(std::string const& name, std::optional<Divergence> const& divergence)
+{
+    if (!divergence)
+    {
+        std::printf("ok        %s\n", name.c_str());
+        return true;
+    }
+
+    std::printf("DIVERGED  %s\n  after %llu instructions at %03X: %s\n%s",
+                name.c_str(), static_cast<unsigned long long>(divergence->instruction), divergence->pc,
+                divergence->difference.c_str(), divergence->window.c_str());
+    return false;
+}
+
+/**
+ * Runs the interpreter and a second engine in lockstep and reports the first divergence.
+ * Built from a recompiled ROM (CHIP8_RECOMPILED) it checks the compiled code for that ROM,
+ * otherwise it checks the switch engine against every ROM given.
+ * Every ROM is run twice, without and with the display-wait quirk.
+ */
+int main(int argc, char* argv[])
+{
+    unsigned long frames = 600;
+    unsigned int cyclesPerFrame = 12;
+    unsigned int interval = 64;
+    std::vector<std::filesystem::path> roms;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--cycles") == 0 && i + 1 < argc)
+        {
+            cyclesPerFrame = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+        {
+            interval = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::filesystem::is_directory(argv[i]))
+        {
+            for (auto const& entry : std::filesystem::recursive_directory_iterator(argv[i]))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".ch8")
+                {
+                    roms.push_back(entry.path());
+                }
+            }
+        }
+        else
+        {
+            roms.emplace_back(argv[i]);
+        }
+    }
+
+    InterpreterEngine reference;
+    bool agreed = true;
+
+#ifdef CHIP8_RECOMPILED
+    RecompiledEngine candidate;
+    LockstepValidator validator(reference, candidate, interval);
+    agreed = Report(RECOMPILED_ROM_NAME, validator.Validate(RECOMPILED_ROM, RECOMPILED_ROM_SIZE, frames, cyclesPerFrame));
+    agreed &= Report(std::string(RECOMPILED_ROM_NAME) + " (display wait)",
+                     validator.Validate(RECOMPILED_ROM, RECOMPILED_ROM_SIZE, frames, cyclesPerFrame, true));
+#else
+    if (roms.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--frames N] [--cycles N] [--interval N] <ROM or dir>...\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    SwitchEngine candidate;
+    LockstepValidator validator(reference, candidate, interval);
+
+    std::sort(roms.begin(), roms.end());
+    for (std::filesystem::path const& path : roms)
+    {
+        const MappedFile rom(path.string().c_str());
+        if (!rom.IsOpen())
+        {
+            std::cerr << "Could not open " << path.string() << "\n";
+            agreed = false;
+            continue;
+        }
+
+        agreed &= Report(path.filename().string(), validator.Validate(rom.Data(), rom.Size(), frames, cyclesPerFrame));
+        agreed &= Report(path.filename().string() + " (display wait)",
+                         validator.Validate(rom.Data(), rom.Size(), frames, cyclesPerFrame, true));
+    }
+#endif
+
+    return agreed ? 0 : 1;
+}
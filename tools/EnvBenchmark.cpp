@@ -0,0 +1,73 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../Environment.cpp"
+#include "../MappedFile.cpp"
+
+/**
+ * Steps a batch of environments with random keys and reports the throughput.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: " << argv[0] << " <ROM> <Instances> <Threads> <Steps> [FrameSkip]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    MappedFile rom(argv[1]);
+    if (!rom.IsOpen())
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const size_t count = std::strtoul(argv[2], nullptr, 10);
+    const unsigned long steps = std::strtoul(argv[4], nullptr, 10);
+    if (count == 0)
+    {
+        std::cerr << "Instances must be at least 1\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    EnvConfig config;
+    config.threads = std::strtoul(argv[3], nullptr, 10);
+    if (argc > 5)
+    {
+        config.frameSkip = std::strtoul(argv[5], nullptr, 10);
+    }
+
+    Chip8Env env(rom.Data(), rom.Size(), count, config);
+
+    std::vector<uint8_t> observations(count * env.ObservationSize());
+    std::vector<uint16_t> actions(count);
+    std::vector<float> rewards(count);
+    std::vector<uint8_t> dones(count);
+    std::mt19937 keys(1);
+
+    env.Reset(1, observations.data());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned long step = 0; step < steps; ++step)
+    {
+        for (uint16_t& action : actions)
+        {
+            action = 1u << (keys() & 0xFu);
+        }
+        env.Step(actions.data(), observations.data(), rewards.data(), dones.data());
+    }
+    const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+
+    const double total = static_cast<double>(steps) * count;
+    std::printf("%.0f steps in %.2f s, %.0f steps/s, %.0f frames/s\n",
+                total, seconds, total / seconds, total * config.frameSkip / seconds);
+
+    return 0;
+}
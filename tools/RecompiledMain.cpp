@@ -0,0 +1,64 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include "Chip8.cpp"
+#include "Engine.cpp"
+#include "Platform.cpp"
+
+constexpr float FRAME_TIME = 1000.0f / 60.0f;
+
+/**
+ * Driver for a ROM-specific executable, the ROM and its code are linked in.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <Scale> <CyclesPerFrame>\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const int videoScale = std::stoi(argv[1]);
+    const unsigned int cyclesPerFrame = std::stoul(argv[2]);
+
+    const std::string title = std::string("CHIP-8 Emulator - ") + RECOMPILED_ROM_NAME;
+
+    Platform platform(title.c_str(),
+        static_cast<int>(VIDEO_WIDTH) * videoScale,
+        static_cast<int>(VIDEO_HEIGHT) * videoScale,
+        VIDEO_WIDTH,
+        VIDEO_HEIGHT);
+
+    Chip8 chip8;
+    chip8.LoadROM(RECOMPILED_ROM, RECOMPILED_ROM_SIZE);
+
+    RecompiledEngine engine;
+
+    auto lastFrameTime = std::chrono::high_resolution_clock::now();
+    bool quit = false;
+
+    while (!quit && !chip8.exited)
+    {
+        quit = platform.ProcessInput(chip8.keypad);
+
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float dt = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastFrameTime).count();
+
+        if (dt > FRAME_TIME)
+        {
+            lastFrameTime = currentTime;
+
+            engine.RunFrame(chip8, cyclesPerFrame);
+
+            platform.UpdateAudio(chip8.audioPattern, chip8.pitch, chip8.soundTimer > 0);
+            platform.Update(&chip8.video[0][0][0],
+                static_cast<int>(chip8.VideoWidth()), static_cast<int>(chip8.VideoHeight()));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Analyzer.cpp"
+#include "../MappedFile.cpp"
+
+/**
+ * Full report for one ROM: blocks with successors, call graph, data regions and warnings.
+ */
+void PrintReport(RomAnalysis const& analysis)
+{
+    std::printf("Blocks\n");
+    for (BasicBlock const& block : analysis.blocks)
+    {
+        std::printf("  %03X-%03X ->", block.start, block.end - 1);
+        for (const uint16_t successor : block.successors)
+        {
+            std::printf(" %03X", successor);
+        }
+        if (block.call)
+        {
+            std::printf(" call %03X", block.call);
+        }
+        if (block.returns)
+        {
+            std::printf(" ret");
+        }
+        if (block.computedJump)
+        {
+            std::printf(" computed");
+        }
+        std::printf("\n");
+    }
+
+    std::printf("Functions\n");
+    for (Function const& function : analysis.functions)
+    {
+        std::printf("  %03X (%zu blocks) calls", function.entry, function.blocks.size());
+        for (const uint16_t callee : function.callees)
+        {
+            std::printf(" %03X", callee);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("Data\n");
+    for (AddressRange const& range : analysis.data)
+    {
+        std::printf("  %03X-%03X (%d bytes)\n", range.start, range.end - 1, range.end - range.start);
+    }
+
+    for (const uint16_t address : analysis.computedJumps)
+    {
+        std::printf("Computed jump at %03X\n", address);
+    }
+    for (const uint16_t address : analysis.selfModifying)
+    {
+        std::printf("Self-modifying write at %03X\n", address);
+    }
+    for (const uint16_t address : analysis.invalid)
+    {
+        std::printf("Invalid opcode at %03X\n", address);
+    }
+}
+
+/**
+ * Graphviz version of the CFG, one cluster per function.
+ */
+void PrintDot(RomAnalysis const& analysis)
+{
+    std::printf("digraph cfg {\n  node [shape=box fontname=monospace];\n");
+
+    for (Function const& function : analysis.functions)
+    {
+        std::printf("  subgraph cluster_%03X {\n    label=\"sub_%03X\";\n", function.entry, function.entry);
+        for (const uint16_t start : function.blocks)
+        {
+            std::printf("    b%03X;\n", start);
+        }
+        std::printf("  }\n");
+    }
+
+    for (BasicBlock const& block : analysis.blocks)
+    {
+        std::printf("  b%03X [label=\"%03X-%03X\"];\n", block.start, block.start, block.end - 1);
+        for (const uint16_t successor : block.successors)
+        {
+            std::printf("  b%03X -> b%03X;\n", block.start, successor);
+        }
+        if (block.call)
+        {
+            std::printf("  b%03X -> b%03X [style=dashed];\n", block.start, block.call);
+        }
+    }
+
+    std::printf("}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    bool dot = false;
+    std::vector<std::filesystem::path> roms;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--dot") == 0)
+        {
+            dot = true;
+        }
+        else if (std::filesystem::is_directory(argv[i]))
+        {
+            for (const auto& item : std::filesystem::recursive_directory_iterator(argv[i]))
+            {
+                if (item.is_regular_file() && item.path().extension() == ".ch8")
+                {
+                    roms.push_back(item.path());
+                }
+            }
+        }
+        else
+        {
+            roms.emplace_back(argv[i]);
+        }
+    }
+
+    if (roms.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--dot] <ROM or directory>...\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // One ROM gets the full report, several get a summary line each
+    const bool summary = roms.size() > 1;
+    double totalMs = 0;
+
+    for (const auto& path : roms)
+    {
+        const MappedFile file(path.string().c_str());
+        if (!file.IsOpen())
+        {
+            std::cerr << "Could not open " << path.string() << "\n";
+            continue;
+        }
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        const RomAnalysis analysis = Analyzer::Analyze(file.Data(), file.Size());
+        const auto end = std::chrono::high_resolution_clock::now();
+        totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (!summary)
+        {
+            dot ? PrintDot(analysis) : PrintReport(analysis);
+            continue;
+        }
+
+        size_t dataBytes = 0;
+        for (AddressRange const& range : analysis.data)
+        {
+            dataBytes += range.end - range.start;
+        }
+
+        std::printf("%5zu blocks %4zu functions %5zu data bytes %2zu computed %2zu smc %2zu invalid  %s\n",
+            analysis.blocks.size(), analysis.functions.size(), dataBytes, analysis.computedJumps.size(),
+            analysis.selfModifying.size(), analysis.invalid.size(), path.filename().string().c_str());
+    }
+
+    std::fprintf(stderr, "Analyzed %zu ROMs in %.3f ms\n", roms.size(), totalMs);
+
+    return 0;
+}
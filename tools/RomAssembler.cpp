@@ -0,0 +1,50 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "../Assembler.cpp"
+
+/**
+ * Assembles a source file written with the core's OP_xxxx instruction names into a ROM.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <Source.asm> <Output.ch8>\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in)
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+
+    Assembler assembler;
+    std::vector<uint8_t> rom;
+    if (!assembler.Assemble(source.str(), rom))
+    {
+        std::cerr << argv[1] << ": " << assembler.Error() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const*>(rom.data()), static_cast<std::streamsize>(rom.size()));
+    if (!out)
+    {
+        std::cerr << "Could not write " << argv[2] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::cout << rom.size() << " bytes\n";
+    return 0;
+}
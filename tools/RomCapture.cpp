@@ -0,0 +1,58 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "../Capture.cpp"
+#include "../Chip8.cpp"
+
+/**
+ * Headless capture: run a ROM for a number of frames and record every one,
+ * for previews, regression videos and datasets.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: " << argv[0] << " <ROM> <Frames> <CyclesPerFrame> <Output.y4m | Output dir> [Scale]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    char const* romFilename = argv[1];
+    const unsigned long frames = std::strtoul(argv[2], nullptr, 10);
+    const unsigned int cyclesPerFrame = std::strtoul(argv[3], nullptr, 10);
+    const std::string output = argv[4];
+    const unsigned int scale = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 4;
+
+    const bool y4m = output.size() >= 4 && output.compare(output.size() - 4, 4, ".y4m") == 0;
+    if (!y4m)
+    {
+        std::filesystem::create_directories(output);
+    }
+
+    FrameCapture capture(output, y4m ? CaptureFormat::Y4M : CaptureFormat::PPM, scale);
+    if (!capture.IsOpen())
+    {
+        std::cerr << "Could not open " << output << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    Chip8 chip8;
+    chip8.LoadROM(romFilename);
+
+    for (unsigned long frame = 0; frame < frames && !chip8.exited; ++frame)
+    {
+        chip8.RunFrame(cyclesPerFrame);
+        capture.Submit(chip8);
+    }
+
+    std::printf("%u frames, %u unique, %u repeated\n",
+                capture.unique + capture.duplicates, capture.unique, capture.duplicates);
+
+    return 0;
+}
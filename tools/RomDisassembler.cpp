@@ -0,0 +1,182 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Chip8.cpp"
+#include "../Disassembler.cpp"
+#include "../MappedFile.cpp"
+
+/**
+ * Run a ROM and print every instruction executed, pc, opcode and text.
+ */
+void Trace(Disassembler const& disassembler, MappedFile const& rom, unsigned long instructions)
+{
+    Chip8 chip8;
+    chip8.LoadROM(rom.Data(), rom.Size());
+
+    std::vector<char> buffer(1 << 20);
+    size_t used = 0;
+
+    for (unsigned long i = 0; i < instructions; ++i)
+    {
+        if (buffer.size() - used < DISASSEMBLY_MAX_TEXT + 16)
+        {
+            std::fwrite(buffer.data(), 1, used, stdout);
+            used = 0;
+        }
+
+        const uint16_t pc = chip8.pc & MEMORY_MASK;
+        const uint16_t opcode = (chip8.memory[pc] << 8u) | chip8.memory[(pc + 1) & MEMORY_MASK];
+        const uint16_t operand = (chip8.memory[(pc + 2) & MEMORY_MASK] << 8u) | chip8.memory[(pc + 3) & MEMORY_MASK];
+
+        char* line = buffer.data() + used;
+        // As wide as the largest address, so columns line up when pc goes past 0xFFF
+        const auto written = static_cast<size_t>(std::snprintf(line, 16, "%0*X  %04X  ", MEMORY_SIZE > 0x1000 ? 4 : 3, pc, opcode));
+        size_t length = written + disassembler.Format(opcode, operand, line + written);
+        line[length++] = '\n';
+        used += length;
+
+        chip8.Cycle();
+    }
+
+    std::fwrite(buffer.data(), 1, used, stdout);
+}
+
+/**
+ * Disassembles ROMs into listings that Chip8_RomAssembler reads back byte for byte.
+ * One ROM goes to stdout, any number go to <name>.asm files in an output folder, one thread per core.
+ * --trace runs the ROM instead and prints each executed instruction.
+ */
+int main(int argc, char* argv[])
+{
+    std::filesystem::path outputDir;
+    unsigned long trace = 0;
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::filesystem::path> roms;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            outputDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::filesystem::is_directory(argv[i]))
+        {
+            for (auto const& entry : std::filesystem::recursive_directory_iterator(argv[i]))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".ch8")
+                {
+                    roms.push_back(entry.path());
+                }
+            }
+        }
+        else
+        {
+            roms.emplace_back(argv[i]);
+        }
+    }
+
+    if (roms.empty() || (roms.size() > 1 && outputDir.empty()))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--trace Instructions] <ROM>\n"
+                  << "       " << argv[0] << " [--threads N] -o <OutputDir> <ROM or directory>...\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const Disassembler disassembler;
+
+    if (outputDir.empty())
+    {
+        MappedFile rom(roms[0].string().c_str());
+        if (!rom.IsOpen())
+        {
+            std::cerr << "Could not open " << roms[0] << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        if (trace)
+        {
+            Trace(disassembler, rom, trace);
+        }
+        else
+        {
+            disassembler.Listing(rom.Data(), rom.Size(), stdout);
+        }
+        return 0;
+    }
+
+    std::filesystem::create_directories(outputDir);
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> lines{0};
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        std::string listing;
+        for (size_t i = next++; i < roms.size(); i = next++)
+        {
+            MappedFile rom(roms[i].string().c_str());
+            if (!rom.IsOpen())
+            {
+                std::cerr << "Could not open " << roms[i] << "\n";
+                failed = true;
+                continue;
+            }
+
+            listing.clear();
+            size_t count = 0;
+            disassembler.Listing(rom.Data(), rom.Size(), [&](std::string_view line) {
+                listing += line;
+                ++count;
+            });
+            lines += count;
+
+            const std::filesystem::path path = outputDir / roms[i].filename().replace_extension(".asm");
+            FILE* out = std::fopen(path.string().c_str(), "w");
+            if (!out || std::fwrite(listing.data(), 1, listing.size(), out) != listing.size())
+            {
+                std::cerr << "Could not write " << path << "\n";
+                failed = true;
+            }
+            if (out)
+            {
+                std::fclose(out);
+            }
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    std::printf("%zu ROMs, %zu lines in %.1f ms on %u threads\n",
+                roms.size(), lines.load(), elapsed.count() * 1000, threadCount);
+    return failed ? EXIT_FAILURE : 0;
+}
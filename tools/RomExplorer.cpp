@@ -0,0 +1,78 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "../Explorer.cpp"
+#include "../MappedFile.cpp"
+
+/**
+ * Explores the states a ROM can reach from its keypad and reports
+ * how many were found per input step and every crash with the inputs that cause it.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <ROM> [Depth] [CyclesPerFrame] [MaxStates] [Threads] [Seed]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    MappedFile rom(argv[1]);
+    if (!rom.IsOpen())
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    ExplorerConfig config;
+    if (argc > 2)
+    {
+        config.maxDepth = std::strtoul(argv[2], nullptr, 10);
+    }
+    if (argc > 3)
+    {
+        config.cyclesPerFrame = std::strtoul(argv[3], nullptr, 10);
+    }
+    if (argc > 4)
+    {
+        config.maxStates = std::strtoull(argv[4], nullptr, 10);
+    }
+    if (argc > 5)
+    {
+        config.threads = std::strtoul(argv[5], nullptr, 10);
+    }
+    if (argc > 6)
+    {
+        config.seed = std::strtoull(argv[6], nullptr, 10);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const ExplorationResult result = StateExplorer::Explore(rom.Data(), rom.Size(), config);
+    const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::printf("Depth  New states\n");
+    for (size_t depth = 0; depth < result.statesPerDepth.size(); ++depth)
+    {
+        std::printf("%5zu  %zu\n", depth, result.statesPerDepth[depth]);
+    }
+    std::printf("%zu states, %zu exits%s, %.2f s\n",
+                result.states, result.exits, result.truncated ? ", stopped at the state limit" : "", seconds);
+
+    // Inputs are keypad bitmasks per step, "-" for no key
+    for (CrashState const& crash : result.crashes)
+    {
+        std::printf("%s at %03X (%04X) after %zu inputs:",
+                    CrashName(crash.kind), crash.pc, crash.opcode, crash.inputs.size());
+        for (const uint16_t input : crash.inputs)
+        {
+            input ? std::printf(" %X", input) : std::printf(" -");
+        }
+        std::printf("\n");
+    }
+
+    return result.crashes.empty() ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include "../Chip8.cpp"
+
+// Enough cycles to get through most of a 3.5 KB ROM a few times over
+constexpr unsigned int FUZZ_CYCLES = 10000;
+
+/**
+ * libFuzzer entry point.
+ * Treats the input as a ROM image and runs it through the core.
+ * Keys are toggled from the cycle count so Ex9E/ExA1/Fx0A paths get exercised too.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    Chip8 chip8;
+    chip8.LoadROM(data, size);
+
+    for (unsigned int i = 0; i < FUZZ_CYCLES; ++i)
+    {
+        chip8.keypad[(i >> 6) & 0xFu] = (i >> 5) & 1u;
+        chip8.Cycle();
+    }
+
+    return 0;
+}
+
+#ifdef CHIP8_FUZZ_STANDALONE
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+/**
+ * Replays ROM files through the harness without libFuzzer,
+ * e.g. to reproduce a crash with a compiler that has no -fsanitize=fuzzer.
+ */
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+        const std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        LLVMFuzzerTestOneInput(rom.data(), rom.size());
+    }
+
+    return 0;
+}
+#endif
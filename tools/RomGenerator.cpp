@@ -0,0 +1,115 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Assembler.cpp"
+#include "../Engine.cpp"
+#include "../StressRom.cpp"
+
+/**
+ * Time an engine over a fixed instruction budget on a freshly loaded ROM.
+ * @return instructions per second
+ */
+double Measure(ExecutionEngine& engine, std::vector<uint8_t> const& rom, unsigned long instructions)
+{
+    Chip8 chip8;
+    chip8.LoadROM(rom.data(), rom.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned long done = 0; done < instructions;)
+    {
+        const unsigned int chunk = instructions - done < 1000000 ? instructions - done : 1000000;
+        engine.Run(chip8, chunk);
+        done += chunk;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    return instructions / elapsed.count();
+}
+
+bool Write(std::filesystem::path const& path, void const* data, size_t size)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(out);
+}
+
+/**
+ * Emits synthetic ROMs that each hammer one group of opcodes, as .ch8 plus the .asm they came from,
+ * and optionally times every engine on them.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <draw|alu|call|memory|all> <OutputDir> [Instructions] [Seed]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::vector<StressMix> mixes;
+    if (std::string(argv[1]) == "all")
+    {
+        for (unsigned int i = 0; i < static_cast<unsigned int>(StressMix::COUNT); ++i)
+        {
+            mixes.push_back(static_cast<StressMix>(i));
+        }
+    }
+    else if (StressMix mix; ParseStressMix(argv[1], mix))
+    {
+        mixes.push_back(mix);
+    }
+    else
+    {
+        std::cerr << "Unknown mix " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const std::filesystem::path outputDir(argv[2]);
+    const unsigned long instructions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    const unsigned int seed = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 1;
+    std::filesystem::create_directories(outputDir);
+
+    Assembler assembler;
+    InterpreterEngine interpreter;
+    SwitchEngine switchEngine;
+    ExecutionEngine* engines[] = {&interpreter, &switchEngine};
+
+    for (const StressMix mix : mixes)
+    {
+        const std::string source = StressRomGenerator(seed).Generate(mix);
+        std::vector<uint8_t> rom;
+        if (!assembler.Assemble(source, rom))
+        {
+            std::cerr << StressMixName(mix) << ": " << assembler.Error() << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        const std::filesystem::path base = outputDir / (std::string("stress_") + StressMixName(mix));
+        if (!Write(base.string() + ".asm", source.data(), source.size()) ||
+            !Write(base.string() + ".ch8", rom.data(), rom.size()))
+        {
+            std::cerr << "Could not write " << base << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        std::printf("%-8s %4zu bytes", StressMixName(mix), rom.size());
+        if (instructions)
+        {
+            for (ExecutionEngine* engine : engines)
+            {
+                std::printf("  %s %.1f MIPS", engine->Name(), Measure(*engine, rom, instructions) / 1e6);
+            }
+        }
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "../RomLibrary.cpp"
+
+/**
+ * Scans a ROM directory and (re)writes the library index.
+ * An existing index is loaded first so per-ROM settings survive a rescan.
+ * With --set, stores the video scale and cycle delay main uses when given 0 for a ROM.
+ */
+int main(int argc, char* argv[])
+{
+    const bool set = argc > 1 && std::strcmp(argv[1], "--set") == 0;
+
+    if ((set && (argc < 5 || argc > 6)) || (!set && argc > 3))
+    {
+        std::cerr << "Usage: " << argv[0] << " [ROM directory] [Index file]\n"
+                  << "       " << argv[0] << " --set <ROM> <Scale> <Delay> [Index file]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    RomLibrary library;
+
+    if (set)
+    {
+        char const* indexFile = argc > 5 ? argv[5] : ROM_INDEX_FILE;
+        library.Load(indexFile);
+
+        RomEntry* entry = library.Add(argv[2]);
+        if (!entry)
+        {
+            std::cerr << "Could not open " << argv[2] << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        entry->settings.videoScale = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+        entry->settings.cycleDelay = static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10));
+
+        if (!library.Save(indexFile))
+        {
+            std::cerr << "Could not write " << indexFile << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        std::cout << entry->title << ": scale " << entry->settings.videoScale
+                  << ", delay " << entry->settings.cycleDelay << "\n";
+        return 0;
+    }
+
+    char const* romDirectory = argc > 1 ? argv[1] : "roms";
+    char const* indexFile = argc > 2 ? argv[2] : ROM_INDEX_FILE;
+
+    library.Load(indexFile);
+    library.Scan(romDirectory);
+
+    if (!library.Save(indexFile))
+    {
+        std::cerr << "Could not write " << indexFile << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::cout << library.Entries().size() << " ROMs indexed in " << indexFile << "\n";
+
+    return 0;
+}
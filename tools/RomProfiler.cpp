@@ -0,0 +1,51 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "../MappedFile.cpp"
+#include "../Profiler.cpp"
+
+/**
+ * Runs a ROM headless for a number of frames and reports where its instructions went,
+ * per guest subroutine and as folded stacks for flamegraph tooling.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <ROM> <Frames> <CyclesPerFrame> [Output.folded]\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    MappedFile rom(argv[1]);
+    if (!rom.IsOpen())
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const unsigned long frames = std::strtoul(argv[2], nullptr, 10);
+    const unsigned int cyclesPerFrame = std::strtoul(argv[3], nullptr, 10);
+
+    Chip8 chip8;
+    chip8.LoadROM(rom.Data(), rom.Size());
+
+    Profiler profiler;
+    for (unsigned long frame = 0; frame < frames && !chip8.exited; ++frame)
+    {
+        profiler.RunFrame(chip8, cyclesPerFrame);
+    }
+
+    profiler.PrintSummary(stdout);
+
+    if (argc > 4 && !profiler.WriteFolded(argv[4]))
+    {
+        std::cerr << "Could not write " << argv[4] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    return 0;
+}
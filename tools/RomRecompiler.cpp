@@ -0,0 +1,154 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "../Analyzer.cpp"
+#include "../MappedFile.cpp"
+
+/**
+ * Emit one function per basic block.
+ * Each instruction becomes pc/opcode setup plus a direct call to its handler with a
+ * constant opcode, which the optimizer can inline and fold completely.
+ * @return instructions in the block
+ */
+unsigned int EmitBlock(std::ofstream& out, BasicBlock const& block, uint8_t const* rom)
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "    unsigned int Block_%03X(Chip8& chip8)\n    {\n", block.start);
+    out << line;
+
+    unsigned int count = 0;
+
+    for (unsigned int address = block.start; address < block.end; ++count)
+    {
+        const unsigned int offset = address - START_ADDRESS;
+        const auto opcode = static_cast<uint16_t>((rom[offset] << 8u) | (offset + 1 < block.end - START_ADDRESS ? rom[offset + 1] : 0));
+        const Op op = DecodeOp(opcode);
+
+        std::snprintf(line, sizeof(line),
+            "        chip8.pc = 0x%03X; chip8.opcode = 0x%04X; chip8.%s(); chip8.TickTimers();\n",
+            address + 2, opcode, OpName(op));
+        out << line;
+
+        // Fx0A waits for a key and a display-wait Dxyn for the vblank, both by rewinding the pc,
+        // the block has to stop there or the next instruction's pc setup would skip them
+        if ((op == Op::OP_Fx0A || op == Op::OP_Dxyn) && address + 2 < block.end)
+        {
+            std::snprintf(line, sizeof(line), "        if (chip8.pc != 0x%03X) { return %u; }\n", address + 2, count + 1);
+            out << line;
+        }
+
+        address += OpLength(op);
+    }
+
+    std::snprintf(line, sizeof(line), "        return %u;\n    }\n\n", count);
+    out << line;
+
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <ROM> <Output.cpp>\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const MappedFile file(argv[1]);
+    if (!file.IsOpen())
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const size_t size = std::min<size_t>(file.Size(), MAX_ROM_SIZE);
+    const RomAnalysis analysis = Analyzer::Analyze(file.Data(), size);
+
+    std::ofstream out(argv[2], std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "Could not write " << argv[2] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const std::string name = std::filesystem::path(argv[1]).filename().string();
+
+    out << "// Generated by Chip8_Recompiler from " << name << ", do not edit\n\n";
+    out << "#include \"Chip8.cpp\"\n#include \"Recompiled.h\"\n\nnamespace\n{\n";
+
+    // Blocks the ROM writes into are left to the interpreter, compiled they would go stale
+    auto written = [&](BasicBlock const& block) {
+        return std::any_of(analysis.codeWrites.begin(), analysis.codeWrites.end(),
+            [&](AddressRange const& range) { return range.start < block.end && block.start < range.end; });
+    };
+
+    std::vector<unsigned int> lengths;
+    size_t compiled = 0;
+    for (BasicBlock const& block : analysis.blocks)
+    {
+        lengths.push_back(written(block) ? 0 : EmitBlock(out, block, file.Data()));
+        compiled += lengths.back() > 0;
+    }
+
+    out << "}\n\nunsigned int RunRecompiledBlock(Chip8& chip8)\n{\n    switch (chip8.pc)\n    {\n";
+
+    char line[96];
+    for (size_t i = 0; i < analysis.blocks.size(); ++i)
+    {
+        if (lengths[i] > 0)
+        {
+            std::snprintf(line, sizeof(line), "        case 0x%03X: return Block_%03X(chip8);\n",
+                analysis.blocks[i].start, analysis.blocks[i].start);
+            out << line;
+        }
+    }
+
+    out << "        default: chip8.Cycle(); return 1;\n    }\n}\n\n";
+
+    out << "unsigned int RecompiledBlockLength(uint16_t pc)\n{\n    switch (pc)\n    {\n";
+    for (size_t i = 0; i < analysis.blocks.size(); ++i)
+    {
+        if (lengths[i] > 0)
+        {
+            std::snprintf(line, sizeof(line), "        case 0x%03X: return %u;\n", analysis.blocks[i].start, lengths[i]);
+            out << line;
+        }
+    }
+    out << "        default: return 0;\n    }\n}\n\n";
+
+    out << "const uint8_t RECOMPILED_ROM[] = {";
+    for (size_t i = 0; i < size; ++i)
+    {
+        std::snprintf(line, sizeof(line), "%s0x%02X,", i % 16 ? " " : "\n    ", file.Data()[i]);
+        out << line;
+    }
+    out << "\n};\n\nconst size_t RECOMPILED_ROM_SIZE = " << size << ";\n";
+
+    // Keep the name a valid string literal whatever the file is called
+    std::string escaped;
+    for (const char c : name)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    out << "char const* const RECOMPILED_ROM_NAME = \"" << escaped << "\";\n";
+
+    std::cout << compiled << " blocks recompiled from " << name;
+    if (compiled < analysis.blocks.size())
+    {
+        std::cout << ", " << analysis.blocks.size() - compiled << " it writes into left to the interpreter";
+    }
+    std::cout << "\n";
+
+    return 0;
+}
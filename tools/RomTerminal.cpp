@@ -0,0 +1,90 @@
+//
+// Created by _edd.ie_ on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../Chip8.cpp"
+#include "../MappedFile.cpp"
+#include "../TerminalPlatform.cpp"
+
+constexpr auto TERMINAL_FRAME_TIME = std::chrono::microseconds(1000000 / 60);
+// Cycles per frame when no delay is given, as in the SDL front end
+constexpr unsigned int TERMINAL_CYCLES_PER_FRAME = 1000;
+
+/**
+ * Plays a ROM in the terminal, no SDL or display needed, for watching a session over SSH.
+ */
+int main(int argc, char** argv)
+{
+    TerminalMode mode = TerminalMode::HalfBlock;
+    if (argc > 1 && std::strcmp(argv[1], "--braille") == 0)
+    {
+        mode = TerminalMode::Braille;
+        --argc;
+        ++argv;
+    }
+
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--braille] <Delay|vip|vip-accurate> <ROM>\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const TimingMode timing = std::strcmp(argv[1], "vip") == 0 ? TimingMode::VipTable
+                            : std::strcmp(argv[1], "vip-accurate") == 0 ? TimingMode::VipAccurate
+                            : TimingMode::Instructions;
+    const int cycleDelay = timing == TimingMode::Instructions ? std::atoi(argv[1]) : 0;
+    const unsigned int cyclesPerFrame = cycleDelay > 0
+        ? std::max(1u, static_cast<unsigned int>(1000.0f / 60.0f / static_cast<float>(cycleDelay)))
+        : TERMINAL_CYCLES_PER_FRAME;
+
+    const MappedFile rom(argv[2]);
+    if (!rom.IsOpen())
+    {
+        std::cerr << "Could not open " << argv[2] << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    Chip8 chip8;
+    chip8.LoadROM(rom.Data(), rom.Size());
+    chip8.displayWait = timing != TimingMode::Instructions;
+
+    unsigned long frames = 0;
+    unsigned long long bytes;
+    {
+        TerminalPlatform platform((std::string("CHIP-8 - ") + argv[2]).c_str(), mode);
+        auto next = std::chrono::steady_clock::now();
+
+        while (!platform.ProcessInput(chip8.keypad) && !chip8.exited)
+        {
+            if (timing == TimingMode::Instructions)
+            {
+                chip8.RunFrame(cyclesPerFrame);
+            }
+            else
+            {
+                chip8.RunTimedFrame(timing);
+            }
+
+            platform.UpdateAudio(chip8.audioPattern, chip8.pitch, chip8.soundTimer > 0);
+            platform.Update(&chip8.video[0][0][0],
+                static_cast<int>(chip8.VideoWidth()), static_cast<int>(chip8.VideoHeight()));
+            ++frames;
+
+            next += TERMINAL_FRAME_TIME;
+            std::this_thread::sleep_until(next);
+        }
+
+        bytes = platform.BytesWritten();
+    }
+
+    // After the terminal is restored, so it stays on screen
+    std::cerr << frames << " frames, " << bytes << " bytes, "
+              << (frames ? bytes / frames : 0) << " bytes per frame\n";
+    return 0;
+}